@@ -401,6 +401,24 @@ const int TOOL_LENGTH_OFFSET_AXIS = Z_AXIS;  // Default z-axis. Valid values are
 // received, including not only GCode lines, but also $ and [ESP commands.
 //#define REPORT_ECHO_RAW_LINE_RECEIVED // Default disabled. Uncomment to enable.
 
+// Lets the g-code parser execute plain G0/G1 lines that carry only axis, F, S and N words
+// without running the full modal-group parse. Lines that need anything else, and any
+// line that would produce an error, fall through to the full parser unchanged.
+#define USE_GCODE_FAST_PATH  // Default enabled. Comment to disable.
+
+// Size of the O-word subroutine cache, in g-code words of 8 bytes each, and the number of
+// subroutines it can hold. Subroutine and repeat bodies are tokenized once and kept here.
+// The cache is allocated on first use, from PSRAM when the board has it.
+const int SUBROUTINE_CACHE_WORDS = 4096;
+const int MAX_SUBROUTINES        = 32;
+
+// Runs SD jobs in a loop that feeds lines to the parser for as long as the planner has
+// room, instead of one line per pass of the main loop. SD lines are answered the same
+// way as without it: no ok, and error:N for a line that fails.
+#define SD_FAST_STREAMING  // Default enabled. Comment to disable.
+// Lines the SD loop may run in one pass before client input gets a turn
+const int SD_STREAM_MAX_LINES = 64;
+
 // Minimum planner junction speed. Sets the default minimum junction speed the planner plans to at
 // every buffer block junction, except for starting from rest and end of the buffer, which are always
 // zero. This value controls how fast the machine moves through junctions with no regard for acceleration
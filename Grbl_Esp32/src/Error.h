@@ -64,6 +64,8 @@ enum class Error : uint8_t {
     GcodeG43DynamicAxisError    = 37,
     GcodeMaxValueExceeded       = 38,
     PParamMaxExceeded           = 39,
+    GcodeUndefinedSubroutine    = 40,
+    GcodeSubroutineMismatch     = 41,
     FsFailedMount               = 60,  // SD Failed to mount
     FsFailedRead                = 61,  // SD Failed to read file
     FsFailedOpenDir             = 62,  // SD card failed to open directory
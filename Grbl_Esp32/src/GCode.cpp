@@ -35,6 +35,8 @@ CoordIndex& operator++(CoordIndex& i) {
 // value when converting a float (7.2 digit precision)s to an integer.
 static const int32_t MaxLineNumber = 10000000;
 static const uint8_t MaxToolNumber = 255;  // Limited by max unsigned 8-bit value
+static const uint8_t MaxSubCallDepth = 8;    // Nested O-word calls, bounded by task stack
+static const float   CannedClearance = 0.254;  // mm. G73 chip-break retract and G83 re-approach gap.
 
 // Declare gc extern struct
 parser_state_t gc_state;
@@ -42,9 +44,12 @@ parser_block_t gc_block;
 
 #define FAIL(status) return (status);
 
+static void sub_reset();
+
 void gc_init() {
     // Reset parser state:
     memset(&gc_state, 0, sizeof(parser_state_t));
+    sub_reset();
     // Load default G54 coordinate system.
     gc_state.modal.coord_select = CoordIndex::G54;
     coords[gc_state.modal.coord_select]->get(gc_state.coord_system);
@@ -115,6 +120,413 @@ void collapseGCode(char* line) {
     *outPtr = '\0';
 }
 
+#ifdef USE_GCODE_FAST_PATH
+// Executes a block if it is a plain G0/G1 move, i.e. only axis words plus optional
+// F, S and N words and at most one G0/G1 word, using the current modal state. Returns false,
+// without changing any state, if the block needs the full parser for any reason, including
+// every case where the full parser would report an error. The execution below mirrors the
+// corresponding steps of gc_execute_block() so both paths produce the same planner blocks.
+static bool gc_execute_fast_motion(const gc_words_t* block) {
+    if (block->jog || block->error != Error::Ok) {
+        return false;
+    }
+    if (gc_state.modal.feed_rate != FeedRate::UnitsPerMin || spindle->inLaserMode()) {
+        return false;
+    }
+    static const char axis_letters[] = "XYZABC";  // In axis index order
+    float             xyz[MAX_N_AXIS];
+    Motion            motion     = gc_state.modal.motion;
+    auto              n_axis     = number_axis->get();
+    float             f          = gc_state.feed_rate;
+    float             s          = gc_state.spindle_speed;
+    int32_t           n          = 0;
+    uint8_t           axis_words = 0;
+    uint8_t           seen       = 0;  // Non-axis words seen, in bit order G, F, S, N
+    for (uint8_t word_index = 0; word_index < block->count; word_index++) {
+        char    letter   = block->word[word_index].letter;
+        float   value    = block->word[word_index].value;
+        uint8_t seen_bit = 0;
+        uint8_t axis     = 0;
+        switch (letter) {
+            case 'G':
+                if (value == 0.0) {
+                    motion = Motion::Seek;
+                } else if (value == 1.0) {
+                    motion = Motion::Linear;
+                } else {
+                    return false;
+                }
+                seen_bit = bit(0);
+                break;
+            case 'F':
+                f        = value;
+                seen_bit = bit(1);
+                break;
+            case 'S':
+                s        = value;
+                seen_bit = bit(2);
+                break;
+            case 'N':
+                if (value > MaxLineNumber) {
+                    return false;
+                }
+                n        = trunc(value);
+                seen_bit = bit(3);
+                break;
+            default:
+                const char* axis_letter = strchr(axis_letters, letter);
+                if (axis_letter == NULL) {
+                    return false;
+                }
+                axis = axis_letter - axis_letters;
+                break;
+        }
+        if (!seen_bit) {
+            if (axis >= n_axis || bit_istrue(axis_words, bit(axis))) {
+                return false;
+            }
+            xyz[axis] = value;
+            axis_words |= bit(axis);
+        } else {
+            if (bit_istrue(seen, seen_bit) || (letter != 'G' && value < 0.0)) {
+                return false;
+            }
+            seen |= seen_bit;
+        }
+    }
+    if (!axis_words || (motion != Motion::Seek && motion != Motion::Linear)) {
+        return false;
+    }
+    if (gc_state.modal.units == Units::Inches && bit_istrue(seen, bit(1))) {
+        f *= MM_PER_INCH;
+    }
+    if (motion == Motion::Linear && f == 0.0) {
+        return false;
+    }
+    for (uint8_t idx = 0; idx < n_axis; idx++) {
+        if (bit_isfalse(axis_words, bit(idx))) {
+            xyz[idx] = gc_state.position[idx];
+            continue;
+        }
+        if (gc_state.modal.units == Units::Inches) {
+            xyz[idx] *= MM_PER_INCH;
+        }
+        if (gc_state.modal.distance == Distance::Absolute) {
+            xyz[idx] += gc_state.coord_system[idx] + gc_state.coord_offset[idx];
+            if (idx == TOOL_LENGTH_OFFSET_AXIS) {
+                xyz[idx] += gc_state.tool_length_offset;
+            }
+        } else {
+            xyz[idx] += gc_state.position[idx];
+        }
+    }
+    for (uint8_t idx = n_axis; idx < MAX_N_AXIS; idx++) {
+        xyz[idx] = 0.0;  // Matches the zeroed gc_block in the full parser.
+    }
+
+    // Same order of execution as STEP 4 of gc_execute_block().
+    plan_line_data_t  plan_data;
+    plan_line_data_t* pl_data = &plan_data;
+    memset(pl_data, 0, sizeof(plan_line_data_t));
+    gc_state.line_number = n;
+#ifdef USE_LINE_NUMBERS
+    pl_data->line_number = gc_state.line_number;
+#endif
+    gc_state.feed_rate = f;
+    pl_data->feed_rate = gc_state.feed_rate;
+    if (gc_state.spindle_speed != s) {
+        if (gc_state.modal.spindle != SpindleState::Disable) {
+            spindle->sync(gc_state.modal.spindle, (uint32_t)s);
+        }
+        gc_state.spindle_speed = s;
+    }
+    pl_data->spindle_speed = gc_state.spindle_speed;
+    pl_data->spindle       = gc_state.modal.spindle;
+    pl_data->coolant       = gc_state.modal.coolant;
+    gc_state.modal.motion  = motion;
+    if (motion == Motion::Seek) {
+        pl_data->motion.rapidMotion = 1;
+    }
+    limitsCheckSoft(xyz);
+    cartesian_to_motors(xyz, pl_data, gc_state.position);
+    memcpy(gc_state.position, xyz, sizeof(xyz));
+    gc_state.modal.program_flow = ProgramFlow::Running;
+    return true;
+}
+#endif
+
+static bool is_canned_cycle(Motion motion) {
+    return motion == Motion::DrillChipBreak || motion == Motion::Drill || motion == Motion::DrillDwell || motion == Motion::DrillPeck;
+}
+
+// Moves to target, which must not be gc_state.position, and makes it the parser position.
+static void gc_canned_move(float* target, plan_line_data_t* pl_data, bool rapid) {
+    pl_data->motion.rapidMotion = rapid;
+    limitsCheckSoft(target);
+    cartesian_to_motors(target, pl_data, gc_state.position);
+    memcpy(gc_state.position, target, sizeof(gc_state.position));
+}
+
+// Generates the moves of a canned drilling cycle block straight into the planner, once for each
+// of its L repeats. target holds the hole XY in machine coordinates. In incremental mode each
+// repeat is offset from the previous hole by the programmed XY distance. r_plane and depth are
+// machine Z values, already checked so that depth is not above r_plane.
+static void gc_execute_canned_cycle(const float* target, plan_line_data_t* pl_data, float r_plane, float depth, uint8_t repeat) {
+    Motion motion  = gc_state.modal.motion;
+    float  clear_z = r_plane;
+    float  peck    = r_plane - depth;  // G81 and G82 drill in a single pass
+    float  step[2] = { 0.0, 0.0 };
+    float  hole[MAX_N_AXIS];
+    if (gc_state.modal.canned_return == CannedReturn::OldZ) {
+        clear_z = MAX(gc_state.canned.old_z, r_plane);
+    }
+    if (motion == Motion::DrillPeck || motion == Motion::DrillChipBreak) {
+        peck = gc_state.canned.q;
+    }
+    if (gc_state.modal.distance == Distance::Incremental) {
+        step[0] = target[X_AXIS] - gc_state.position[X_AXIS];
+        step[1] = target[Y_AXIS] - gc_state.position[Y_AXIS];
+    }
+    memcpy(hole, gc_state.position, sizeof(hole));
+    if (hole[Z_AXIS] < r_plane) {
+        hole[Z_AXIS] = r_plane;  // Never traverse below the R plane
+        gc_canned_move(hole, pl_data, true);
+    }
+    for (uint8_t i = 0; i < repeat && !sys.abort; i++) {
+        if (gc_state.modal.distance == Distance::Incremental) {
+            hole[X_AXIS] += step[0];
+            hole[Y_AXIS] += step[1];
+        } else {
+            hole[X_AXIS] = target[X_AXIS];
+            hole[Y_AXIS] = target[Y_AXIS];
+        }
+        gc_canned_move(hole, pl_data, true);
+        hole[Z_AXIS] = r_plane;
+        gc_canned_move(hole, pl_data, true);
+        float bottom = r_plane;
+        while (bottom > depth && !sys.abort) {
+            if (bottom < r_plane && motion == Motion::DrillPeck) {
+                hole[Z_AXIS] = MIN(bottom + CannedClearance, r_plane);  // Back down to just above the last peck
+                gc_canned_move(hole, pl_data, true);
+            }
+            bottom       = MAX(bottom - peck, depth);
+            hole[Z_AXIS] = bottom;
+            gc_canned_move(hole, pl_data, false);
+            if (bottom > depth) {
+                // G83 clears chips by leaving the hole, G73 only breaks them with a short retract
+                hole[Z_AXIS] = (motion == Motion::DrillPeck) ? r_plane : MIN(bottom + CannedClearance, r_plane);
+                gc_canned_move(hole, pl_data, true);
+            }
+        }
+        if (motion == Motion::DrillDwell) {
+            mc_dwell(int32_t(gc_state.canned.p * 1000.0f));
+        }
+        hole[Z_AXIS] = clear_z;
+        gc_canned_move(hole, pl_data, true);
+    }
+}
+
+// O-word subroutines (sub/endsub/call) and repeat blocks (repeat/endrepeat). Body lines are
+// tokenized once, as they are received, and kept in a bounded pool, so calls and repeats
+// replay the blocks without reading or parsing text again. The pool holds blocks back to
+// back, each introduced by a header word whose letter is '\0' for a g-code block, with
+// the word count as value, or 'O' for a nested call, with the O number as value.
+typedef struct {
+    uint32_t number;
+    uint16_t start;   // First pool entry
+    uint16_t length;  // Pool entries, including block headers
+} gc_sub_t;
+
+enum class SubRecording : uint8_t {
+    None   = 0,
+    Sub    = 1,
+    Repeat = 2,
+};
+
+static gc_word_t*   sub_pool      = NULL;
+static uint16_t     sub_pool_used = 0;
+static gc_sub_t     subs[MAX_SUBROUTINES];
+static uint8_t      sub_count     = 0;
+static SubRecording sub_recording = SubRecording::None;
+static uint8_t      sub_client;        // Whose lines are being recorded
+static gc_sub_t     sub_pending;       // Body being recorded, always at the top of the pool
+static uint32_t     sub_repeat_count;  // Iterations of the repeat being recorded
+static Error        sub_error;         // First error in the body being recorded
+
+static void sub_reset() {
+    sub_pool_used = 0;
+    sub_count     = 0;
+    sub_recording = SubRecording::None;
+}
+
+// A body is recorded from the lines of the client that began it. Lines from other
+// clients, such as jogs or commands from the WebUI, still run as they arrive.
+static bool sub_recording_for(uint8_t client) {
+    return sub_recording != SubRecording::None && sub_client == client;
+}
+
+static gc_sub_t* sub_find(uint32_t number) {
+    for (uint8_t i = 0; i < sub_count; i++) {
+        if (subs[i].number == number) {
+            return &subs[i];
+        }
+    }
+    return NULL;
+}
+
+// Removes a subroutine and closes the gap it leaves in the pool.
+static void sub_remove(gc_sub_t* sub) {
+    uint16_t end = sub->start + sub->length;
+    memmove(&sub_pool[sub->start], &sub_pool[end], (sub_pool_used - end) * sizeof(gc_word_t));
+    sub_pool_used -= sub->length;
+    for (uint8_t i = 0; i < sub_count; i++) {
+        if (subs[i].start > sub->start) {
+            subs[i].start -= sub->length;
+        }
+    }
+    if (sub_pending.start > sub->start) {
+        sub_pending.start -= sub->length;
+    }
+    *sub = subs[--sub_count];
+}
+
+static Error sub_begin(SubRecording recording, uint32_t number, uint8_t client) {
+    if (sub_recording != SubRecording::None) {
+        return Error::GcodeSubroutineMismatch;  // Definitions do not nest
+    }
+    if (sub_pool == NULL) {
+        size_t size = SUBROUTINE_CACHE_WORDS * sizeof(gc_word_t);
+        sub_pool    = (gc_word_t*)(psramFound() ? ps_malloc(size) : malloc(size));
+        if (sub_pool == NULL) {
+            return Error::Overflow;
+        }
+    }
+    sub_pending   = { number, sub_pool_used, 0 };
+    sub_error     = Error::Ok;
+    sub_recording = recording;
+    sub_client    = client;
+    return Error::Ok;
+}
+
+// Appends one block to the body being recorded. A failing block is reported now, and the
+// body is then dropped when its end is reached.
+static Error sub_record(gc_word_t header, const gc_words_t* block) {
+    uint8_t count  = block ? block->count : 0;
+    Error   status = block ? block->error : Error::Ok;
+    if (status == Error::Ok && sub_pool_used + 1 + count > SUBROUTINE_CACHE_WORDS) {
+        status = Error::Overflow;
+    }
+    if (sub_error == Error::Ok) {
+        sub_error = status;
+    }
+    if (sub_error == Error::Ok) {
+        sub_pool[sub_pool_used++] = header;
+        if (count) {
+            memcpy(&sub_pool[sub_pool_used], block->word, count * sizeof(gc_word_t));
+            sub_pool_used += count;
+        }
+    }
+    return status;
+}
+
+static Error sub_execute(const gc_sub_t* sub, uint8_t client, uint8_t depth) {
+    static gc_words_t block;
+    if (depth > MaxSubCallDepth) {
+        return Error::Overflow;
+    }
+    uint16_t index = sub->start;
+    uint16_t end   = sub->start + sub->length;
+    while (index < end && !sys.abort) {
+        gc_word_t header = sub_pool[index++];
+        Error     status;
+        if (header.letter == 'O') {
+            const gc_sub_t* callee = sub_find(header.value);
+            status                 = callee ? sub_execute(callee, client, depth + 1) : Error::GcodeUndefinedSubroutine;
+        } else {
+            block.jog   = false;
+            block.error = Error::Ok;
+            block.count = header.value;
+            memcpy(block.word, &sub_pool[index], block.count * sizeof(gc_word_t));
+            index += block.count;
+            status = gc_execute_block(&block, client);
+        }
+        if (status != Error::Ok) {
+            return status;
+        }
+    }
+    return Error::Ok;
+}
+
+// Handles a collapsed O-word line: O<n>SUB, O<n>ENDSUB, O<n>CALL, O<n>REPEAT[<count>]
+// or O<n>ENDREPEAT.
+static Error gc_execute_o_word(const char* line, uint8_t client) {
+    uint8_t char_counter = 1;
+    float   value;
+    if (!read_float(line, &char_counter, &value) || value < 0.0 || value > MaxLineNumber || value != truncf(value)) {
+        return Error::BadNumberFormat;
+    }
+    uint32_t    number  = value;
+    const char* keyword = line + char_counter;
+    if (strcmp(keyword, "SUB") == 0) {
+        return sub_begin(SubRecording::Sub, number, client);
+    }
+    if (strncmp(keyword, "REPEAT[", 7) == 0) {
+        char_counter += 7;
+        if (!read_float(line, &char_counter, &value) || value < 0.0 || value > MaxLineNumber || strcmp(line + char_counter, "]") != 0) {
+            return Error::BadNumberFormat;
+        }
+        sub_repeat_count = value;
+        return sub_begin(SubRecording::Repeat, number, client);
+    }
+    if (strcmp(keyword, "CALL") == 0) {
+        if (sub_recording_for(client)) {
+            return sub_record({ 'O', float(number) }, NULL);
+        }
+        const gc_sub_t* sub = sub_find(number);
+        return sub ? sub_execute(sub, client, 0) : Error::GcodeUndefinedSubroutine;
+    }
+    bool endsub = strcmp(keyword, "ENDSUB") == 0;
+    if (!endsub && strcmp(keyword, "ENDREPEAT") != 0) {
+        return Error::GcodeUnsupportedCommand;
+    }
+    SubRecording expected = endsub ? SubRecording::Sub : SubRecording::Repeat;
+    if (!sub_recording_for(client) || sub_recording != expected || sub_pending.number != number) {
+        return Error::GcodeSubroutineMismatch;
+    }
+    sub_recording      = SubRecording::None;
+    sub_pending.length = sub_pool_used - sub_pending.start;
+    Error status       = sub_error;
+    if (status == Error::Ok && endsub) {
+        gc_sub_t* old = sub_find(number);
+        if (old) {
+            sub_remove(old);  // Redefinition replaces the earlier body
+        }
+        if (sub_count < MAX_SUBROUTINES) {
+            subs[sub_count++] = sub_pending;
+            return Error::Ok;
+        }
+        status = Error::Overflow;
+    }
+    for (uint32_t i = 0; status == Error::Ok && i < sub_repeat_count && !sys.abort; i++) {
+        status = sub_execute(&sub_pending, client, 0);
+    }
+    sub_pool_used = sub_pending.start;  // Repeat bodies and failed definitions are not kept
+    return status;
+}
+
+bool gc_recording_subroutine() {
+    return sub_recording != SubRecording::None;
+}
+
+Error gc_close_subroutine(uint8_t client) {
+    if (!sub_recording_for(client)) {
+        return Error::Ok;
+    }
+    sub_recording = SubRecording::None;
+    sub_pool_used = sub_pending.start;
+    return Error::GcodeSubroutineMismatch;  // [Unterminated sub or repeat]
+}
+
 // Executes one line of NUL-terminated G-Code.
 // The line may contain whitespace and comments, which are first removed,
 // and lower case characters, which are converted to upper case.
@@ -122,11 +534,65 @@ void collapseGCode(char* line) {
 // exported to grbl's internal functions in terms of (mm, mm/min) and absolute machine
 // coordinates, respectively.
 Error gc_execute_line(char* line, uint8_t client) {
+    static gc_words_t line_words;  // Too large for the caller's stack
     // Step 0 - remove whitespace and comments and convert to upper case
     collapseGCode(line);
 #ifdef REPORT_ECHO_LINE_RECEIVED
     report_echo_line_received(line, client);
 #endif
+    if (line[0] == 'O') {
+        return gc_execute_o_word(line, client);
+    }
+    gc_tokenize_line(line, &line_words);
+    return gc_execute_block(&line_words, client);
+}
+
+// Splits a collapsed line into letter/value words. Parsing stops at the first malformed
+// word and the error is kept in the block, so gc_execute_block() reports it only after
+// the words before it, in the same order as a character-by-character parse would.
+void gc_tokenize_line(const char* line, gc_words_t* block) {
+    uint8_t char_counter = 0;
+    float   value;
+    // NOTE: `$J=` already parsed when passed to this function. Any other '$', e.g. after
+    // leading whitespace that the line dispatch did not see, fails as a missing letter.
+    block->jog   = strncmp(line, "$J=", 3) == 0;
+    block->error = Error::Ok;
+    block->count = 0;
+    if (block->jog) {
+        char_counter = 3;  // Start parsing after `$J=`
+    }
+    while (line[char_counter] != 0) {
+        char letter = line[char_counter];
+        if ((letter < 'A') || (letter > 'Z')) {
+            block->error = Error::ExpectedCommandLetter;  // [Expected word letter]
+            return;
+        }
+        char_counter++;
+        if (!read_float(line, &char_counter, &value)) {
+            block->error = Error::BadNumberFormat;  // [Expected word value]
+            return;
+        }
+        if (block->count == MAX_GCODE_WORDS) {
+            block->error = Error::Overflow;
+            return;
+        }
+        block->word[block->count].letter = letter;
+        block->word[block->count].value  = value;
+        block->count++;
+    }
+}
+
+// Executes one block of words produced by gc_tokenize_line(), either just now from a
+// received line or earlier when an SD file was compiled.
+Error gc_execute_block(const gc_words_t* block, uint8_t client) {
+    if (sub_recording_for(client) && !block->jog) {
+        return sub_record({ '\0', float(block->count) }, block);
+    }
+#ifdef USE_GCODE_FAST_PATH
+    if (gc_execute_fast_motion(block)) {
+        return Error::Ok;
+    }
+#endif
 
     /* -------------------------------------------------------------------------------------
        STEP 1: Initialize parser block struct and copy current g-code state modes. The parser
@@ -151,7 +617,7 @@ Error gc_execute_line(char* line, uint8_t client) {
     uint8_t  pValue;                  // Integer value of P word
 
     // Determine if the line is a jogging motion or a normal g-code block.
-    if (line[0] == '$') {  // NOTE: `$J=` already parsed when passed to this function.
+    if (block->jog) {
         // Set G1 and G94 enforced modes to ensure accurate error checks.
         gc_parser_flags |= GCParserJogMotion;
         gc_block.modal.motion    = Motion::Linear;
@@ -168,26 +634,13 @@ Error gc_execute_line(char* line, uint8_t client) {
        words, and for negative values set for the value words F, N, P, T, and S. */
     ModalGroup mg_word_bit;  // Bit-value for assigning tracking variables
     uint32_t   bitmask = 0;
-    uint8_t    char_counter;
     char       letter;
     float      value;
     uint8_t    int_value = 0;
     uint16_t   mantissa  = 0;
-    if (gc_parser_flags & GCParserJogMotion) {
-        char_counter = 3;  // Start parsing after `$J=`
-    } else {
-        char_counter = 0;
-    }
-    while (line[char_counter] != 0) {  // Loop until no more g-code words in line.
-        // Import the next g-code word, expecting a letter followed by a value. Otherwise, error out.
-        letter = line[char_counter];
-        if ((letter < 'A') || (letter > 'Z')) {
-            FAIL(Error::ExpectedCommandLetter);  // [Expected word letter]
-        }
-        char_counter++;
-        if (!read_float(line, &char_counter, &value)) {
-            FAIL(Error::BadNumberFormat);  // [Expected word value]
-        }
+    for (uint8_t word_index = 0; word_index < block->count; word_index++) {  // Loop until no more g-code words in block.
+        letter = block->word[word_index].letter;
+        value  = block->word[word_index].value;
         // Convert values to smaller uint8 significand and mantissa values for parsing this word.
         // NOTE: Mantissa is multiplied by 100 to catch non-integer command values. This is more
         // accurate than the NIST gcode requirement of x10 when used for commands, but not quite
@@ -195,8 +648,15 @@ Error gc_execute_line(char* line, uint8_t client) {
         // a good enough compromise and catch most all non-integer errors. To make it compliant,
         // we would simply need to change the mantissa to int16, but this add compiled flash space.
         // Maybe update this later.
-        int_value = trunc(value);
-        mantissa  = round(100 * (value - int_value));  // Compute mantissa for Gxx.x commands.
+        // NOTE: Converting a value outside 0-255 to uint8_t is undefined, so such values map to 255,
+        // which no G or M command uses. Words that take an integer check the range themselves.
+        if (value >= 0.0 && value < 256.0) {
+            int_value = trunc(value);
+            mantissa  = round(100 * (value - int_value));  // Compute mantissa for Gxx.x commands.
+        } else {
+            int_value = 255;
+            mantissa  = 0;
+        }
         // NOTE: Rounding must be used to catch small floating point errors.
         // Check if the g-code word is supported or errors due to modal group violations or has
         // been repeated in the g-code block. If ok, update the command or record its value.
@@ -313,6 +773,34 @@ Error gc_execute_line(char* line, uint8_t client) {
                         gc_block.modal.motion = Motion::None;
                         mg_word_bit           = ModalGroup::MG1;
                         break;
+                    case 73:  // G73 - drilling cycle with chip breaking
+                        axis_command          = AxisCommand::MotionMode;
+                        gc_block.modal.motion = Motion::DrillChipBreak;
+                        mg_word_bit           = ModalGroup::MG1;
+                        break;
+                    case 81:  // G81 - drilling cycle
+                        axis_command          = AxisCommand::MotionMode;
+                        gc_block.modal.motion = Motion::Drill;
+                        mg_word_bit           = ModalGroup::MG1;
+                        break;
+                    case 82:  // G82 - drilling cycle with dwell
+                        axis_command          = AxisCommand::MotionMode;
+                        gc_block.modal.motion = Motion::DrillDwell;
+                        mg_word_bit           = ModalGroup::MG1;
+                        break;
+                    case 83:  // G83 - peck drilling cycle
+                        axis_command          = AxisCommand::MotionMode;
+                        gc_block.modal.motion = Motion::DrillPeck;
+                        mg_word_bit           = ModalGroup::MG1;
+                        break;
+                    case 98:
+                        gc_block.modal.canned_return = CannedReturn::OldZ;
+                        mg_word_bit                  = ModalGroup::MG10;
+                        break;
+                    case 99:
+                        gc_block.modal.canned_return = CannedReturn::RPlane;
+                        mg_word_bit                  = ModalGroup::MG10;
+                        break;
                     case 17:
                         gc_block.modal.plane_select = Plane::XY;
                         mg_word_bit                 = ModalGroup::MG2;
@@ -619,12 +1107,22 @@ Error gc_execute_line(char* line, uint8_t client) {
                         ijk_words |= bit(Z_AXIS);
                         break;
                     case 'L':
-                        axis_word_bit     = GCodeWord::L;
+                        axis_word_bit = GCodeWord::L;
+                        if (value < 0.0) {
+                            FAIL(Error::NegativeValue);
+                        }
+                        if (value > 255) {
+                            FAIL(Error::GcodeMaxValueExceeded);
+                        }
+                        if (mantissa > 0) {
+                            FAIL(Error::GcodeCommandValueNotInteger);  // [L must be an integer]
+                        }
                         gc_block.values.l = int_value;
                         break;
                     case 'N':
-                        axis_word_bit     = GCodeWord::N;
-                        gc_block.values.n = trunc(value);
+                        axis_word_bit = GCodeWord::N;
+                        // Out of range values are kept out of range for the checks below, without overflowing int32_t.
+                        gc_block.values.n = (value > MaxLineNumber) ? MaxLineNumber + 1 : (value < 0.0) ? -1 : trunc(value);
                         break;
                     case 'P':
                         axis_word_bit     = GCodeWord::P;
@@ -697,6 +1195,9 @@ Error gc_execute_line(char* line, uint8_t client) {
                 value_words |= bitmask;  // Flag to indicate parameter assigned.
         }
     }
+    if (block->error != Error::Ok) {
+        FAIL(block->error);  // Malformed word following the ones above
+    }
     // Parsing complete!
     /* -------------------------------------------------------------------------------------
        STEP 3: Error-check all commands and values passed in this block. This step ensures all of
@@ -860,6 +1361,7 @@ Error gc_execute_line(char* line, uint8_t client) {
             }
         }
     }
+    float z_word = gc_block.values.xyz[Z_AXIS];  // Z as programmed, for canned cycle depth
 
     // [13. Cutter radius compensation ]: G41/42 NOT SUPPORTED. Error, if enabled while G53 is active.
     // [G40 Errors]: G2/3 arc is programmed after a G40. The linear move after disabling is less than tool diameter.
@@ -1044,6 +1546,10 @@ Error gc_execute_line(char* line, uint8_t client) {
             }
     }
     // [20. Motion modes ]:
+    gc_canned_t canned         = gc_state.canned;  // Canned cycle values for this block
+    float       canned_r_plane = 0.0;              // Machine Z of the canned cycle R plane
+    float       canned_depth   = 0.0;              // Machine Z of the canned cycle hole bottom
+    uint8_t     canned_repeat  = 1;                // Canned cycle L word
     if (gc_block.modal.motion == Motion::None) {
         // [G80 Errors]: Axis word are programmed while G80 is active.
         // NOTE: Even non-modal commands or TLO that use axis words will throw this strict error.
@@ -1222,6 +1728,84 @@ Error gc_execute_line(char* line, uint8_t client) {
                         }
                     }
                     break;
+                case Motion::DrillChipBreak:
+                case Motion::Drill:
+                case Motion::DrillDwell:
+                case Motion::DrillPeck: {
+                    // [Canned cycle Errors]: Not in the XY plane. Inverse time mode. No axis words. Axis words
+                    //   other than XYZ. R or Z missing when the cycle begins. Q missing or not positive for G73/G83.
+                    //   Hole bottom above the R plane. L zero.
+                    // NOTE: R, Z, Q and P are sticky while a canned cycle stays active, as in LinuxCNC.
+                    if (gc_block.modal.plane_select != Plane::XY || gc_block.modal.feed_rate == FeedRate::InverseTime) {
+                        FAIL(Error::GcodeUnsupportedCommand);
+                    }
+                    if (!axis_words) {
+                        FAIL(Error::GcodeNoAxisWords);  // [No axis words]
+                    }
+                    if (axis_words & ~(bit(X_AXIS) | bit(Y_AXIS) | bit(Z_AXIS))) {
+                        FAIL(Error::GcodeAxisWordsExist);
+                    }
+                    bool continuing = is_canned_cycle(gc_state.modal.motion);
+                    if (!continuing) {
+                        canned.q     = 0.0;
+                        canned.p     = 0.0;
+                        canned.old_z = gc_state.position[Z_AXIS];
+                    }
+                    if (value_words & bit(GCodeWord::R)) {
+                        bit_false(value_words, bit(GCodeWord::R));
+                        canned.r = gc_block.values.r;
+                        if (gc_block.modal.units == Units::Inches) {
+                            canned.r *= MM_PER_INCH;
+                        }
+                    } else if (!continuing) {
+                        FAIL(Error::GcodeValueWordMissing);  // [R word missing]
+                    }
+                    if (axis_words & bit(Z_AXIS)) {
+                        canned.z = z_word;
+                    } else if (!continuing) {
+                        FAIL(Error::GcodeValueWordMissing);  // [Z word missing]
+                    }
+                    if (gc_block.modal.motion == Motion::DrillChipBreak || gc_block.modal.motion == Motion::DrillPeck) {
+                        if (value_words & bit(GCodeWord::Q)) {
+                            bit_false(value_words, bit(GCodeWord::Q));
+                            canned.q = gc_block.values.q;
+                            if (gc_block.modal.units == Units::Inches) {
+                                canned.q *= MM_PER_INCH;
+                            }
+                            if (canned.q <= 0.0) {
+                                FAIL(Error::NegativeValue);  // [Q must be positive]
+                            }
+                        } else if (canned.q <= 0.0) {
+                            FAIL(Error::GcodeValueWordMissing);  // [Q word missing]
+                        }
+                    }
+                    if (gc_block.modal.motion == Motion::DrillDwell && (value_words & bit(GCodeWord::P))) {
+                        bit_false(value_words, bit(GCodeWord::P));
+                        canned.p = gc_block.values.p;
+                    }
+                    if (value_words & bit(GCodeWord::L)) {
+                        bit_false(value_words, bit(GCodeWord::L));
+                        if (gc_block.values.l == 0) {
+                            FAIL(Error::NegativeValue);  // [L must be positive]
+                        }
+                        canned_repeat = gc_block.values.l;
+                    }
+                    // In incremental mode R is relative to the current Z and the depth is relative to R.
+                    if (gc_block.modal.distance == Distance::Absolute) {
+                        float offset = block_coord_system[Z_AXIS] + gc_state.coord_offset[Z_AXIS];
+                        if (TOOL_LENGTH_OFFSET_AXIS == Z_AXIS) {
+                            offset += gc_state.tool_length_offset;
+                        }
+                        canned_r_plane = canned.r + offset;
+                        canned_depth   = canned.z + offset;
+                    } else {
+                        canned_r_plane = gc_state.position[Z_AXIS] + canned.r;
+                        canned_depth   = canned_r_plane + canned.z;
+                    }
+                    if (canned_depth > canned_r_plane) {
+                        FAIL(Error::GcodeInvalidTarget);  // [Hole bottom above R plane]
+                    }
+                } break;
                 case Motion::ProbeTowardNoError:
                 case Motion::ProbeAwayNoError:
                     gc_parser_flags |= GCParserProbeIsNoError;  // No break intentional.
@@ -1507,6 +2091,8 @@ Error gc_execute_line(char* line, uint8_t client) {
         default:
             break;
     }
+    // [Canned cycle return mode ]:
+    gc_state.modal.canned_return = gc_block.modal.canned_return;
     // [20. Motion modes ]:
     // NOTE: Commands G10,G28,G30,G92 lock out and prevent axis words from use in motion modes.
     // Enter motion modes only if there are axis words or a motion mode command word in the block.
@@ -1521,6 +2107,10 @@ Error gc_execute_line(char* line, uint8_t client) {
                 pl_data->motion.rapidMotion = 1;  // Set rapid motion flag.
                 limitsCheckSoft(gc_block.values.xyz);
                 cartesian_to_motors(gc_block.values.xyz, pl_data, gc_state.position);
+            } else if (is_canned_cycle(gc_state.modal.motion)) {
+                gc_state.canned = canned;
+                gc_execute_canned_cycle(gc_block.values.xyz, pl_data, canned_r_plane, canned_depth, canned_repeat);
+                gc_update_pos = GCUpdatePos::None;  // The cycle tracks the position move by move
             } else if ((gc_state.modal.motion == Motion::CwArc) || (gc_state.modal.motion == Motion::CcwArc)) {
                 mc_arc(gc_block.values.xyz,
                        pl_data,
@@ -33,7 +33,7 @@
 
 enum class ModalGroup : uint8_t {
     MG0  = 0,   // [G4,G10,G28,G28.1,G30,G30.1,G53,G92,G92.1] Non-modal
-    MG1  = 1,   // [G0,G1,G2,G3,G38.2,G38.3,G38.4,G38.5,G80] Motion
+    MG1  = 1,   // [G0,G1,G2,G3,G38.2,G38.3,G38.4,G38.5,G73,G80,G81,G82,G83] Motion
     MG2  = 2,   // [G17,G18,G19] Plane selection
     MG3  = 3,   // [G90,G91] Distance mode
     MG4  = 4,   // [G91.1] Arc IJK distance mode
@@ -49,6 +49,7 @@ enum class ModalGroup : uint8_t {
     MM8  = 13,  // [M7,M8,M9] Coolant control
     MM9  = 14,  // [M56] Override control
     MM10 = 15,  // [M62, M63, M64, M65, M67, M68] User Defined http://linuxcnc.org/docs/html/gcode/overview.html#_modal_groups
+    MG10 = 16,  // [G98,G99] Canned cycle return mode
 };
 
 // Command actions for within execution-type modal groups (motion, stopping, non-modal). Used
@@ -84,6 +85,16 @@ enum class Motion : uint8_t {
     ProbeAway          = 142,  // G38.4 (Do not alter value)
     ProbeAwayNoError   = 143,  // G38.5 (Do not alter value)
     None               = 80,   // G80 (Do not alter value)
+    DrillChipBreak     = 73,   // G73 (Do not alter value)
+    Drill              = 81,   // G81 (Do not alter value)
+    DrillDwell         = 82,   // G82 (Do not alter value)
+    DrillPeck          = 83,   // G83 (Do not alter value)
+};
+
+// Modal Group G10: Canned cycle return mode
+enum class CannedReturn : uint8_t {
+    OldZ   = 0,  // G98 (Default: Must be zero)
+    RPlane = 1,  // G99
 };
 
 // Modal Group G2: Plane select
@@ -260,7 +271,7 @@ CoordIndex& operator ++ (CoordIndex& i);
 
 // NOTE: When this struct is zeroed, the 0 values in the above types set the system defaults.
 typedef struct {
-    Motion   motion;     // {G0,G1,G2,G3,G38.2,G80}
+    Motion   motion;     // {G0,G1,G2,G3,G38.2,G73,G80,G81,G82,G83}
     FeedRate feed_rate;  // {G93,G94}
     Units    units;      // {G20,G21}
     Distance distance;   // {G90,G91}
@@ -270,12 +281,13 @@ typedef struct {
     ToolLengthOffset tool_length;   // {G43.1,G49}
     CoordIndex       coord_select;  // {G54,G55,G56,G57,G58,G59}
     // uint8_t control;      // {G61} NOTE: Don't track. Only default supported.
-    ProgramFlow  program_flow;  // {M0,M1,M2,M30}
-    CoolantState coolant;       // {M7,M8,M9}
-    SpindleState spindle;       // {M3,M4,M5}
-    ToolChange   tool_change;   // {M6}
-    IoControl    io_control;    // {M62, M63, M67}
-    Override     override;      // {M56}
+    ProgramFlow  program_flow;   // {M0,M1,M2,M30}
+    CoolantState coolant;        // {M7,M8,M9}
+    SpindleState spindle;        // {M3,M4,M5}
+    ToolChange   tool_change;    // {M6}
+    IoControl    io_control;     // {M62, M63, M67}
+    Override     override;       // {M56}
+    CannedReturn canned_return;  // {G98,G99}
 } gc_modal_t;
 
 typedef struct {
@@ -292,6 +304,15 @@ typedef struct {
     float   xyz[MAX_N_AXIS];  // X,Y,Z Translational axes
 } gc_values_t;
 
+// Canned cycle values. R, Z, Q and P are sticky while a cycle stays active.
+typedef struct {
+    float r;      // R plane as programmed, in mm
+    float z;      // Hole depth as programmed, in mm
+    float q;      // Peck increment for G73/G83, in mm
+    float p;      // Dwell at the hole bottom for G82, in seconds
+    float old_z;  // Machine Z when the cycle began, for G98 retract
+} gc_canned_t;
+
 typedef struct {
     gc_modal_t modal;
 
@@ -306,7 +327,8 @@ typedef struct {
     // position in mm. Loaded from non-volatile storage when called.
     float coord_offset[MAX_N_AXIS];  // Retains the G92 coordinate offset (work coordinates) relative to
     // machine zero in mm. Non-persistent. Cleared upon reset and boot.
-    float tool_length_offset;  // Tracks tool length offset value when enabled.
+    float       tool_length_offset;  // Tracks tool length offset value when enabled.
+    gc_canned_t canned;              // Values of the active canned cycle
 } parser_state_t;
 extern parser_state_t gc_state;
 
@@ -324,11 +346,43 @@ enum class AxisCommand : uint8_t {
     ToolLengthOffset = 3,
 };
 
+// A collapsed g-code line split into letter/value words. Every word is at least two
+// characters, so this covers any line that fits in the line buffer.
+const int MAX_GCODE_WORDS = 128;
+
+typedef struct {
+    char  letter;
+    float value;
+} gc_word_t;
+
+typedef struct {
+    bool      jog;    // Line was a `$J=` jog command
+    Error     error;  // Tokenizer error following the last word, or Error::Ok
+    uint8_t   count;
+    gc_word_t word[MAX_GCODE_WORDS];
+} gc_words_t;
+
 // Initialize the parser
 void gc_init();
 
 // Execute one block of rs275/ngc/g-code
 Error gc_execute_line(char* line, uint8_t client);
 
+// Remove whitespace and comments from a line and convert it to upper case
+void collapseGCode(char* line);
+
+// Split a collapsed line into words without executing it
+void gc_tokenize_line(const char* line, gc_words_t* block);
+
+// Execute one block that has already been split into words
+Error gc_execute_block(const gc_words_t* block, uint8_t client);
+
 // Set g-code parser position. Input in steps.
 void gc_sync_position();
+
+// True while an O-word subroutine or repeat body is being recorded rather than run
+bool gc_recording_subroutine();
+
+// Drops a subroutine or repeat body that client left open, as when the file it came
+// from ends or is closed. Returns an error if there was one.
+Error gc_close_subroutine(uint8_t client);
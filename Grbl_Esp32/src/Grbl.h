@@ -54,6 +54,7 @@ const char* const GRBL_VERSION_BUILD = "20211103";
 #include "Uart.h"
 #include "Serial.h"
 #include "Report.h"
+#include "ReportBuilder.h"
 #include "Pins.h"
 #include "Spindles/Spindle.h"
 #include "Motors/Motors.h"
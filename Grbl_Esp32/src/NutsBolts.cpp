@@ -49,15 +49,24 @@ uint8_t read_float(const char* line, uint8_t* char_counter, float* float_ptr) {
     }
 
     // Extract number into fast integer. Track decimal in terms of exponent value.
+    // NOTE: The exponent is wider than the digit count so that long runs of zeros or
+    // dropped digits, which a 255 character line can hold, cannot wrap it around.
     uint32_t intval    = 0;
-    int8_t   exp       = 0;
-    uint8_t  ndigit    = 0;
+    int16_t  exp       = 0;
+    uint8_t  ndigit    = 0;  // Significant digits held in intval
+    bool     hasdigit  = false;
     bool     isdecimal = false;
     while (1) {
         c -= '0';
         if (c <= 9) {
-            ndigit++;
-            if (ndigit <= MAX_INT_DIGITS) {
+            hasdigit = true;
+            if (ndigit == 0 && c == 0) {
+                // Leading zeros carry no precision, so they must not use up MAX_INT_DIGITS.
+                if (isdecimal) {
+                    exp--;
+                }
+            } else if (ndigit < MAX_INT_DIGITS) {
+                ndigit++;
                 if (isdecimal) {
                     exp--;
                 }
@@ -75,7 +84,7 @@ uint8_t read_float(const char* line, uint8_t* char_counter, float* float_ptr) {
         c = *ptr++;
     }
     // Return if no digits have been read.
-    if (!ndigit) {
+    if (!hasdigit) {
         return false;
     }
 
@@ -96,6 +105,10 @@ uint8_t read_float(const char* line, uint8_t* char_counter, float* float_ptr) {
                 fval *= 10.0;
             } while (--exp > 0);
         }
+        // Too many integer digits overflow to infinity, which no setting or word can use.
+        if (!isfinite(fval)) {
+            return false;
+        }
     }
     // Assign floating point value with correct sign.
     if (isnegative) {
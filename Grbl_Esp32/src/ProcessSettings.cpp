@@ -314,6 +314,54 @@ Error restore_settings(const char* value, WebUI::AuthenticationLevel auth_level,
     return Error::Ok;
 }
 
+// $Report/Interval=<ms> subscribes the issuing client to status reports pushed
+// every <ms> milliseconds; $Report/Interval=0 cancels the subscription.
+Error report_interval(const char* value, WebUI::AuthenticationLevel auth_level, WebUI::ESPResponseStream* out) {
+    const uint32_t MinReportInterval = 20;  // ms
+    uint8_t        client            = out->client();
+    if (client >= CLIENT_COUNT || client == CLIENT_INPUT) {
+        return Error::InvalidStatement;
+    }
+    if (!value) {
+        grbl_sendf(client, "$Report/Interval=%d\r\n", report_get_status_interval(client));
+        return Error::Ok;
+    }
+    char*    endptr;
+    uint32_t ms = strtoul(value, &endptr, 10);
+    if (endptr == value || *endptr != '\0') {
+        return Error::BadNumberFormat;
+    }
+    if (ms != 0 && ms < MinReportInterval) {
+        return Error::InvalidValue;
+    }
+    report_set_status_interval(client, ms);
+    return Error::Ok;
+}
+
+// $Report/Delta=<n> makes status reports to the issuing client carry only the fields
+// that changed since its previous report, with a full report every <n>th time.
+// $Report/Delta=0 goes back to full reports.
+Error report_delta_mode(const char* value, WebUI::AuthenticationLevel auth_level, WebUI::ESPResponseStream* out) {
+    uint8_t client = out->client();
+    if (client >= CLIENT_COUNT || client == CLIENT_INPUT) {
+        return Error::InvalidStatement;
+    }
+    if (!value) {
+        grbl_sendf(client, "$Report/Delta=%d\r\n", report_get_delta_keyframe(client));
+        return Error::Ok;
+    }
+    char*    endptr;
+    uint32_t interval = strtoul(value, &endptr, 10);
+    if (endptr == value || *endptr != '\0') {
+        return Error::BadNumberFormat;
+    }
+    if (interval > UINT16_MAX) {
+        return Error::InvalidValue;
+    }
+    report_set_delta_keyframe(client, interval);
+    return Error::Ok;
+}
+
 Error showState(const char* value, WebUI::AuthenticationLevel auth_level, WebUI::ESPResponseStream* out) {
     grbl_sendf(out->client(), "State 0x%x\r\n", sys.state);
     return Error::Ok;
@@ -461,6 +509,8 @@ void make_grbl_commands() {
     new GrblCommand("I", "Build/Info", get_report_build_info, idleOrAlarm);
     new GrblCommand("N", "GCode/StartupLines", report_startup_lines, idleOrAlarm);
     new GrblCommand("RST", "Settings/Restore", restore_settings, idleOrAlarm, WA);
+    new GrblCommand("RI", "Report/Interval", report_interval, anyState);
+    new GrblCommand("RD", "Report/Delta", report_delta_mode, anyState);
 };
 
 // normalize_key puts a key string into canonical form -
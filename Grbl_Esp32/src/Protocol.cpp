@@ -33,16 +33,30 @@ static uint8_t char_counter         = 0;
 static uint8_t comment_char_counter = 0;
 
 typedef struct {
-    char buffer[LINE_BUFFER_SIZE];
-    int  len;
-    int  line_number;
+    char          buffer[LINE_BUFFER_SIZE];
+    int           len;
+    int           line_number;
+    bool          ready;      // buffer holds a complete line waiting to be executed
+    bool          streaming;  // a line was already waiting on the previous pass
+    volatile bool discard;    // the client's input was reset, so the partial line is stale
 } client_line_t;
 client_line_t client_lines[CLIENT_COUNT];
 
+// Lines are scheduled between clients in these classes, highest priority first.
+// Each pass of the main loop runs at most one line per client, so a sender that
+// keeps its input full cannot starve a jog pendant on another interface.
+enum class LinePriority : uint8_t {
+    Jog = 0,      // $J= lines
+    Interactive,  // lines from a client that was idle on the previous pass
+    Streaming,    // lines from a client that had a line waiting on every pass
+    None,         // no complete line yet
+};
+
 static void empty_line(uint8_t client) {
     client_line_t* cl = &client_lines[client];
     cl->len           = 0;
     cl->buffer[0]     = '\0';
+    cl->ready         = false;
 }
 static void empty_lines() {
     for (uint8_t client = 0; client < CLIENT_COUNT; client++) {
@@ -50,6 +64,13 @@ static void empty_lines() {
     }
 }
 
+// Drops the partly received line of a client whose input was reset. The line belongs to
+// the protocol loop, so another task only marks it and the loop empties it before it
+// collects more input from that client.
+void protocol_discard_line(uint8_t client) {
+    client_lines[client].discard = true;
+}
+
 Error add_char_to_line(char c, uint8_t client) {
     client_line_t* cl = &client_lines[client];
     // Simple editing for interactive input
@@ -74,6 +95,39 @@ Error add_char_to_line(char c, uint8_t client) {
     return Error::Ok;
 }
 
+// Reads characters from a client until it has a complete line, without reading
+// past the end of that line. Returns the scheduling class of the line.
+static LinePriority collect_line(uint8_t client) {
+    client_line_t* cl = &client_lines[client];
+    int            c;
+    if (cl->discard) {
+        cl->discard = false;
+        empty_line(client);
+    }
+    while (!cl->ready && (c = client_read(client)) != -1) {
+        switch (add_char_to_line(c, client)) {
+            case Error::Eol:
+                cl->ready = true;
+                break;
+            case Error::Overflow:
+                report_status_message(Error::Overflow, client);
+                empty_line(client);
+                break;
+            default:
+                break;
+        }
+    }
+    bool streaming = cl->streaming;
+    cl->streaming  = cl->ready;
+    if (!cl->ready) {
+        return LinePriority::None;
+    }
+    if (strncasecmp(cl->buffer, "$J=", 3) == 0) {
+        return LinePriority::Jog;
+    }
+    return streaming ? LinePriority::Streaming : LinePriority::Interactive;
+}
+
 Error execute_line(char* line, uint8_t client, WebUI::AuthenticationLevel auth_level) {
     Error result = Error::Ok;
     // Empty or comment line. For syncing purposes.
@@ -91,6 +145,14 @@ Error execute_line(char* line, uint8_t client, WebUI::AuthenticationLevel auth_l
     return gc_execute_line(line, client);
 }
 
+// Same as execute_line() for a g-code block that was already split into words.
+Error execute_block(const gc_words_t* block, uint8_t client) {
+    if (sys.state == State::Alarm || sys.state == State::Jog) {
+        return Error::SystemGcLock;
+    }
+    return gc_execute_block(block, client);
+}
+
 bool can_park() {
     return
 #ifdef ENABLE_PARKING_OVERRIDE_CONTROL
@@ -99,6 +161,53 @@ bool can_park() {
         homing_enable->get() && !spindle->inLaserMode();
 }
 
+#ifdef ENABLE_SD_CARD
+// Ends a job that has run to the end of its file, and starts the next queued job if
+// the job came from the queue.
+static void protocol_sd_done() {
+    Error status = gc_close_subroutine(SD_client);
+    if (status != Error::Ok) {
+        report_status_message(status, SD_client);  // The file ended inside a definition; fail the job
+        return;
+    }
+    char temp[50];
+    sd_get_current_filename(temp);
+    grbl_notifyf("SD print done", "%s print is successful", temp);
+    if (!openNextQueuedFile()) {
+        closeFile();  // close file and clear SD ready/running flags
+    }
+}
+
+#    ifdef SD_FAST_STREAMING
+// Runs SD lines back to back while the planner has room, checking realtime commands
+// between lines. As in the one-line-per-pass path, a successful line is not answered
+// and an error goes through report_status_message(), which sends error:N to the client
+// that started the job and skips the line or stops the job.
+static void protocol_stream_sd() {
+    for (int n = 0; n < SD_STREAM_MAX_LINES && SD_ready_next && plan_get_block_buffer_available(); n++) {
+        protocol_execute_realtime();  // Runtime command check point.
+        if (sys.abort) {
+            return;
+        }
+        Error status;
+        SD_ready_next = false;
+        if (!executeFileLine(&status)) {
+            protocol_sd_done();
+            return;
+        }
+        if (get_sd_state(false) != SDState::BusyPrinting) {
+            return;  // The line ended the job
+        }
+        if (status == Error::Ok) {
+            SD_ready_next = true;
+        } else {
+            report_status_message(status, SD_client);  // Sends error:N and skips the line or stops the job
+        }
+    }
+}
+#    endif
+#endif
+
 /*
   GRBL PRIMARY LOOP:
 */
@@ -135,59 +244,65 @@ void protocol_main_loop() {
     // Primary loop! Upon a system abort, this exits back to main() to reset the system.
     // This is also where Grbl idles while waiting for something to do.
     // ---------------------------------------------------------------------------------
-    int c;
     for (;;) {
 #ifdef ENABLE_SD_CARD
+        if (SD_ready_next && SD_restart_line && !restartFile()) {
+            report_status_message(Error::InvalidValue, SD_client);  // The file ended before the line; stops the job
+        }
         if (SD_ready_next) {
-            char fileLine[255];
-            if (readFileLine(fileLine, 255)) {
-                SD_ready_next = false;
-                report_status_message(execute_line(fileLine, SD_client, SD_auth_level), SD_client);
+#    ifdef SD_FAST_STREAMING
+            protocol_stream_sd();
+            if (sys.abort) {
+                return;  // Bail to main() program loop to reset system.
+            }
+#    else
+            Error status;
+            SD_ready_next = false;
+            if (executeFileLine(&status)) {
+                report_status_message(status, SD_client);
             } else {
-                char temp[50];
-                sd_get_current_filename(temp);
-                grbl_notifyf("SD print done", "%s print is successful", temp);
-                closeFile();  // close file and clear SD ready/running flags
+                protocol_sd_done();
             }
+#    endif
         }
 #endif
-        // Receive one line of incoming serial data, as the data becomes available.
+        // Receive one line of incoming serial data from each client, as the data becomes available.
         // Filtering, if necessary, is done later in gc_execute_line(), so the
         // filtering is the same with serial and file input.
-        uint8_t client = CLIENT_SERIAL;
-        char*   line;
-        for (client = 0; client < CLIENT_COUNT; client++) {
-            while ((c = client_read(client)) != -1) {
-                Error res = add_char_to_line(c, client);
-                switch (res) {
-                    case Error::Ok:
-                        break;
-                    case Error::Eol:
-                        protocol_execute_realtime();  // Runtime command check point.
-                        if (sys.abort) {
-                            return;  // Bail to calling function upon system abort
-                        }
-                        line = client_lines[client].buffer;
+        static uint8_t first_client = 0;  // rotates so clients of equal priority take turns
+        LinePriority   priority[CLIENT_COUNT];
+        bool           pending = false;  // Some client has a complete line
+        for (uint8_t client = 0; client < CLIENT_COUNT; client++) {
+            priority[client] = collect_line(client);
+            pending |= priority[client] != LinePriority::None;
+        }
+        for (uint8_t p = 0; p < static_cast<uint8_t>(LinePriority::None); p++) {
+            for (uint8_t i = 0; i < CLIENT_COUNT; i++) {
+                uint8_t client = (first_client + i) % CLIENT_COUNT;
+                if (priority[client] != static_cast<LinePriority>(p)) {
+                    continue;
+                }
+                protocol_execute_realtime();  // Runtime command check point.
+                if (sys.abort) {
+                    return;  // Bail to calling function upon system abort
+                }
+                char* line = client_lines[client].buffer;
 #ifdef REPORT_ECHO_RAW_LINE_RECEIVED
-                        report_echo_line_received(line, client);
+                report_echo_line_received(line, client);
 #endif
-                        // auth_level can be upgraded by supplying a password on the command line
-                        report_status_message(execute_line(line, client, WebUI::AuthenticationLevel::LEVEL_GUEST), client);
-                        empty_line(client);
-                        break;
-                    case Error::Overflow:
-                        report_status_message(Error::Overflow, client);
-                        empty_line(client);
-                        break;
-                    default:
-                        break;
-                }
-            }  // while serial read
-        }      // for clients
-        // If there are no more characters in the serial read buffer to be processed and executed,
-        // this indicates that g-code streaming has either filled the planner buffer or has
-        // completed. In either case, auto-cycle start, if enabled, any queued moves.
-        protocol_auto_cycle_start();
+                // auth_level can be upgraded by supplying a password on the command line
+                report_status_message(execute_line(line, client, WebUI::AuthenticationLevel::LEVEL_GUEST), client);
+                empty_line(client);
+            }
+        }
+        first_client = (first_client + 1) % CLIENT_COUNT;
+        // If no client had a line to execute, this indicates that g-code streaming has either
+        // filled the planner buffer or has completed. In either case, auto-cycle start, if
+        // enabled, any queued moves. While lines keep arriving, the next pass collects them
+        // first, so the planner is not started on a partial run of blocks.
+        if (!pending) {
+            protocol_auto_cycle_start();
+        }
         protocol_execute_realtime();  // Runtime command check point.
         if (sys.abort) {
             return;  // Bail to main() program loop to reset system.
@@ -48,5 +48,11 @@ void protocol_auto_cycle_start();
 // Block until all buffered steps are executed
 void protocol_buffer_synchronize();
 
+// Drops the partly received line of a client. Safe to call from other tasks.
+void protocol_discard_line(uint8_t client);
+
+// Executes a g-code block that was already split into words, e.g. from a compiled SD job.
+Error execute_block(const gc_words_t* block, uint8_t client);
+
 // Executes the auto cycle feature, if enabled.
 void protocol_auto_cycle_start();
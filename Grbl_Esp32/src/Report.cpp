@@ -48,6 +48,7 @@
 
 #include "Grbl.h"
 #include <map>
+#include <new>
 
 #ifdef REPORT_HEAP
 EspClass esp;
@@ -58,31 +59,64 @@ void grbl_send(uint8_t client, const char* text) {
     client_write(client, text);
 }
 
+// Size of the stack buffer used for formatted output. The rare longer line, such as a
+// long $N startup line or an [echo:] of one, is formatted on the heap instead.
+const int SENDF_BUFFER_SIZE = 256;
+
+// Length of the line ending format ends with: 2 for "\r\n", 1 for "\n", otherwise 0
+static size_t line_end_length(const char* format) {
+    size_t len = strlen(format);
+    if (len >= 2 && format[len - 2] == '\r' && format[len - 1] == '\n') {
+        return 2;
+    }
+    return (len >= 1 && format[len - 1] == '\n') ? 1 : 0;
+}
+
+// Formats prefix + format + suffix in a single pass and hands the result, with its
+// length, to the client. Output that fits SENDF_BUFFER_SIZE stays on the stack. If the
+// heap has no room for a longer line, what fits is sent, with the line ending the
+// format ends with, so the next line still starts on a line of its own.
+static void grbl_vsendf(uint8_t client, const char* prefix, const char* suffix, const char* format, va_list arg) {
+    char    loc_buf[SENDF_BUFFER_SIZE];
+    char*   buf        = loc_buf;
+    size_t  prefix_len = strlen(prefix);
+    size_t  suffix_len = strlen(suffix);
+    size_t  room       = sizeof(loc_buf) - prefix_len - suffix_len;  // includes the terminator
+    va_list copy;
+    va_copy(copy, arg);
+    int n = vsnprintf(buf + prefix_len, room, format, arg);
+    if (n >= 0 && (size_t)n >= room) {
+        buf = new (std::nothrow) char[prefix_len + n + suffix_len + 1];
+        if (buf != NULL) {
+            vsnprintf(buf + prefix_len, n + 1, format, copy);
+        } else {
+            buf            = loc_buf;
+            n              = room - 1;
+            size_t eol_len = suffix_len ? 0 : line_end_length(format);  // A suffix ends the line itself
+            memcpy(buf + prefix_len + n - eol_len, format + strlen(format) - eol_len, eol_len);
+        }
+    }
+    va_end(copy);
+    if (n < 0) {
+        return;
+    }
+    memcpy(buf, prefix, prefix_len);
+    memcpy(buf + prefix_len + n, suffix, suffix_len + 1);
+    client_write(client, buf, prefix_len + n + suffix_len);
+    if (buf != loc_buf) {
+        delete[] buf;
+    }
+}
+
 // This is a formating version of the grbl_send(CLIENT_ALL,...) function that work like printf
 void grbl_sendf(uint8_t client, const char* format, ...) {
     if (client == CLIENT_INPUT) {
         return;
     }
-    char    loc_buf[64];
-    char*   temp = loc_buf;
     va_list arg;
-    va_list copy;
     va_start(arg, format);
-    va_copy(copy, arg);
-    size_t len = vsnprintf(NULL, 0, format, arg);
-    va_end(copy);
-    if (len >= sizeof(loc_buf)) {
-        temp = new char[len + 1];
-        if (temp == NULL) {
-            return;
-        }
-    }
-    len = vsnprintf(temp, len + 1, format, arg);
-    grbl_send(client, temp);
+    grbl_vsendf(client, "", "", format, arg);
     va_end(arg);
-    if (temp != loc_buf) {
-        delete[] temp;
-    }
 }
 // Use to send [MSG:xxxx] Type messages. The level allows messages to be easily suppressed
 void grbl_msg_sendf(uint8_t client, MsgLevel level, const char* format, ...) {
@@ -96,32 +130,16 @@ void grbl_msg_sendf(uint8_t client, MsgLevel level, const char* format, ...) {
         }
     }
 
-    char    loc_buf[100];
-    char*   temp = loc_buf;
     va_list arg;
-    va_list copy;
     va_start(arg, format);
-    va_copy(copy, arg);
-    size_t len = vsnprintf(NULL, 0, format, arg);
-    va_end(copy);
-    if (len >= sizeof(loc_buf)) {
-        temp = new char[len + 1];
-        if (temp == NULL) {
-            return;
-        }
-    }
-    len = vsnprintf(temp, len + 1, format, arg);
-    grbl_sendf(client, "[MSG:%s]\r\n", temp);
+    grbl_vsendf(client, "[MSG:", "]\r\n", format, arg);
     va_end(arg);
-    if (temp != loc_buf) {
-        delete[] temp;
-    }
 }
 
 //function to notify
 void grbl_notify(const char* title, const char* msg) {
 #ifdef ENABLE_NOTIFICATIONS
-    WebUI::notificationsservice.sendMSG(title, msg);
+    WebUI::notificationsservice.queueMSG(title, msg);
 #endif
 }
 
@@ -151,28 +169,30 @@ void grbl_notifyf(const char* title, const char* format, ...) {
 static const int coordStringLen = 20;
 static const int axesStringLen  = coordStringLen * MAX_N_AXIS;
 
-// formats axis values into a string and returns that string in rpt
-// NOTE: rpt should have at least size: axesStringLen
-static void report_util_axis_values(float* axis_value, char* rpt) {
-    uint8_t     idx;
-    char        axisVal[coordStringLen];
-    float       unit_conv = 1.0;      // unit conversion multiplier..default is mm
-    const char* format    = "%4.3f";  // Default - report mm to 3 decimal places
-    rpt[0]                = '\0';
+// Appends the axis values, converted to fixed-point decimal, to rpt
+static void report_util_axis_values(const float* axis_value, ReportBuilder& rpt) {
+    float   unit_conv = 1.0;  // unit conversion multiplier..default is mm
+    uint8_t decimals  = 3;    // Default - report mm to 3 decimal places
     if (report_inches->get()) {
         unit_conv = 1.0 / MM_PER_INCH;
-        format    = "%4.4f";  // Report inches to 4 decimal places
+        decimals  = 4;  // Report inches to 4 decimal places
     }
     auto n_axis = number_axis->get();
-    for (idx = 0; idx < n_axis; idx++) {
-        snprintf(axisVal, coordStringLen - 1, format, axis_value[idx] * unit_conv);
-        strcat(rpt, axisVal);
-        if (idx < (number_axis->get() - 1)) {
-            strcat(rpt, ",");
+    for (uint8_t idx = 0; idx < n_axis; idx++) {
+        if (idx) {
+            rpt.append(',');
         }
+        rpt.append_fixed(axis_value[idx] * unit_conv, decimals);
     }
 }
 
+// formats axis values into a string and returns that string in rpt
+// NOTE: rpt should have at least size: axesStringLen
+static void report_util_axis_values(const float* axis_value, char* rpt) {
+    ReportBuilder builder(rpt, axesStringLen);
+    report_util_axis_values(axis_value, builder);
+}
+
 // This version returns the axis values as a String
 static String report_util_axis_values(const float* axis_value) {
     String  rpt = "";
@@ -343,7 +363,7 @@ void report_ngc_parameters(uint8_t client) {
 // Print current gcode parser mode state
 void report_gcode_modes(uint8_t client) {
     char        temp[20];
-    char        modes_rpt[75];
+    char        modes_rpt[100];
     const char* mode = "";
     strcpy(modes_rpt, "[GC:");
 
@@ -375,6 +395,18 @@ void report_gcode_modes(uint8_t client) {
         case Motion::ProbeAwayNoError:
             mode = "G38.4";
             break;
+        case Motion::DrillChipBreak:
+            mode = "G73";
+            break;
+        case Motion::Drill:
+            mode = "G81";
+            break;
+        case Motion::DrillDwell:
+            mode = "G82";
+            break;
+        case Motion::DrillPeck:
+            mode = "G83";
+            break;
     }
     strcat(modes_rpt, mode);
 
@@ -432,6 +464,16 @@ void report_gcode_modes(uint8_t client) {
     }
     strcat(modes_rpt, mode);
 
+    switch (gc_state.modal.canned_return) {
+        case CannedReturn::OldZ:
+            mode = " G98";
+            break;
+        case CannedReturn::RPlane:
+            mode = " G99";
+            break;
+    }
+    strcat(modes_rpt, mode);
+
     //report_util_gcode_modes_M();
     switch (gc_state.modal.program_flow) {
         case ProgramFlow::Running:
@@ -575,35 +617,163 @@ void report_echo_line_received(char* line, uint8_t client) {
 // float wco            = returns the work coordinate offset
 // bool wpos            = true for work position compensation
 
-// Prints real-time data. This function grabs a real-time snapshot of the stepper subprogram
-// and the actual location of the CNC machine. Users may change the following function to their
-// specific needs, but the desired real-time data report must be as short as possible. This is
-// requires as it minimizes the computational overhead and allows grbl to keep running smoothly,
-// especially during g-code programs with fast, short line segments and high frequency reports (5-20Hz).
-void report_realtime_status(uint8_t client) {
-    char status[200];
-    char temp[MAX_N_AXIS * 20];
+// Delta status reports. A client that enables them with $Report/Delta=<n> is only
+// sent the fields that changed since its last report; the state is always sent.
+// Every <n>th report is a full keyframe. A field that disappears from the report,
+// like Pn: when the last pin is released, is sent once with an empty value.
+enum class ReportField : uint8_t {
+    Position = 0,
+    Buffer,
+    LineNumber,
+    FeedSpeed,
+    Pins,
+    WorkCoordOffset,
+    Overrides,
+    Accessories,
+    SdProgress,
+    Heap,
+    Count,
+};
+
+struct ReportDelta {
+    uint16_t keyframe_interval;  // 0 means delta reports are disabled
+    uint16_t since_keyframe;
+    uint32_t field_hash[static_cast<int>(ReportField::Count)];
+};
+
+static ReportDelta report_delta[CLIENT_COUNT] = {};
+
+static uint32_t report_hash(const char* s, size_t len, uint32_t hash = 2166136261u) {
+    while (len--) {
+        hash = (hash ^ (uint8_t)*s++) * 16777619u;  // FNV-1a
+    }
+    return hash;
+}
+
+void report_set_delta_keyframe(uint8_t client, uint16_t interval) {
+    report_delta[client]                   = {};
+    report_delta[client].keyframe_interval = interval;
+}
+
+uint16_t report_get_delta_keyframe(uint8_t client) {
+    return report_delta[client].keyframe_interval;
+}
+
+// Where a status report field starts, and where its value starts after the label
+struct ReportFieldMark {
+    size_t start;
+    size_t value;
+};
+
+static ReportFieldMark report_begin_field(ReportBuilder& rpt, const char* label) {
+    ReportFieldMark mark;
+    mark.start = rpt.length();
+    rpt.append(label);
+    mark.value = rpt.length();
+    return mark;
+}
+
+// Decides whether the field appended since report_begin_field() stays in the report.
+// In a full report, empty values are omitted. In a delta report, only values that
+// changed are kept, including empty ones. A field that did not fit is dropped
+// whole rather than cut short, and is sent in full once it fits again.
+static void report_end_field(ReportBuilder& rpt, ReportFieldMark mark, ReportField field, ReportDelta* delta, bool keyframe) {
+    if (rpt.overflowed()) {
+        rpt.truncate(mark.start);
+        if (delta) {
+            delta->field_hash[static_cast<int>(field)] = 0;
+        }
+        return;
+    }
+    bool changed = true;
+    if (delta) {
+        uint32_t  hash = report_hash(rpt.c_str() + mark.start, rpt.length() - mark.start);
+        uint32_t& last = delta->field_hash[static_cast<int>(field)];
+        changed        = hash != last;
+        last           = hash;
+    }
+    if (!(keyframe ? rpt.length() > mark.value : changed)) {
+        rpt.truncate(mark.start);
+    }
+}
+
+#ifdef REPORT_FIELD_WORK_COORD_OFFSET
+// Returns true when a full status report is due to include the work coordinate offset.
+static bool report_wco_due() {
+    if (sys.report_wco_counter > 0) {
+        sys.report_wco_counter--;
+        return false;
+    }
+    switch (sys.state) {
+        case State::Homing:
+        case State::Cycle:
+        case State::Hold:
+        case State::Jog:
+        case State::SafetyDoor:
+            sys.report_wco_counter = (REPORT_WCO_REFRESH_BUSY_COUNT - 1);  // Reset counter for slow refresh
+        default:
+            sys.report_wco_counter = (REPORT_WCO_REFRESH_IDLE_COUNT - 1);
+            break;
+    }
+    if (sys.report_ovr_counter == 0) {
+        sys.report_ovr_counter = 1;  // Set override on next report.
+    }
+    return true;
+}
+#endif
+
+#ifdef REPORT_FIELD_OVERRIDES
+// Returns true when a full status report is due to include override and accessory data.
+static bool report_ovr_due() {
+    if (sys.report_ovr_counter > 0) {
+        sys.report_ovr_counter--;
+        return false;
+    }
+    switch (sys.state) {
+        case State::Homing:
+        case State::Cycle:
+        case State::Hold:
+        case State::Jog:
+        case State::SafetyDoor:
+            sys.report_ovr_counter = (REPORT_OVR_REFRESH_BUSY_COUNT - 1);  // Reset counter for slow refresh
+        default:
+            sys.report_ovr_counter = (REPORT_OVR_REFRESH_IDLE_COUNT - 1);
+            break;
+    }
+    return true;
+}
+#endif
+
+static void report_build_realtime_status(ReportBuilder& rpt, uint8_t client) {
+    ReportFieldMark mark;
+    ReportDelta*    delta    = NULL;
+    bool            keyframe = true;
+    if (client < CLIENT_COUNT && report_delta[client].keyframe_interval) {
+        delta                 = &report_delta[client];
+        keyframe              = delta->since_keyframe == 0;
+        delta->since_keyframe = (delta->since_keyframe + 1) % delta->keyframe_interval;
+    }
 
-    strcpy(status, "<");
-    strcat(status, report_state_text());
+    rpt.reserve(3);  // Room for the closing ">\r\n"
+    rpt.append('<');
+    rpt.append(report_state_text());
 
     // Report position
     float* print_position = system_get_mpos();
-    if (bit_istrue(status_mask->get(), RtStatus::Position)) {
-        strcat(status, "|MPos:");
-    } else {
-        strcat(status, "|WPos:");
+    bool   mpos           = bit_istrue(status_mask->get(), RtStatus::Position);
+    if (!mpos) {
         mpos_to_wpos(print_position);
     }
-    report_util_axis_values(print_position, temp);
-    strcat(status, temp);
+    mark = report_begin_field(rpt, mpos ? "|MPos:" : "|WPos:");
+    report_util_axis_values(print_position, rpt);
+    report_end_field(rpt, mark, ReportField::Position, delta, keyframe);
     // Returns planner and serial read buffer states.
 #ifdef REPORT_FIELD_BUFFER_STATE
     if (bit_istrue(status_mask->get(), RtStatus::Buffer)) {
         int bufsize = DEFAULTBUFFERSIZE;
 #    if defined(ENABLE_WIFI) && defined(ENABLE_TELNET)
-        if (client == CLIENT_TELNET) {
-            bufsize = WebUI::telnet_server.get_rx_buffer_available();
+        if (WebUI::Telnet_Server::is_client(client)) {
+            bufsize = WebUI::telnet_server.get_rx_buffer_available(client);
         }
 #    endif  //ENABLE_WIFI && ENABLE_TELNET
 #    if defined(ENABLE_BLUETOOTH)
@@ -615,172 +785,194 @@ void report_realtime_status(uint8_t client) {
         if (client == CLIENT_SERIAL) {
             bufsize = client_get_rx_buffer_available(CLIENT_SERIAL);
         }
-        sprintf(temp, "|Bf:%d,%d", plan_get_block_buffer_available(), bufsize);
-        strcat(status, temp);
+        mark = report_begin_field(rpt, "|Bf:");
+        rpt.append_int(plan_get_block_buffer_available());
+        rpt.append(',');
+        rpt.append_int(bufsize);
+        report_end_field(rpt, mark, ReportField::Buffer, delta, keyframe);
     }
 #endif
 #ifdef USE_LINE_NUMBERS
 #    ifdef REPORT_FIELD_LINE_NUMBERS
     // Report current line number
+    mark                    = report_begin_field(rpt, "|Ln:");
     plan_block_t* cur_block = plan_get_current_block();
     if (cur_block != NULL) {
         uint32_t ln = cur_block->line_number;
         if (ln > 0) {
-            sprintf(temp, "|Ln:%d", ln);
-            strcat(status, temp);
+            rpt.append_uint(ln);
         }
     }
+    report_end_field(rpt, mark, ReportField::LineNumber, delta, keyframe);
 #    endif
 #endif
     // Report realtime feed speed
 #ifdef REPORT_FIELD_CURRENT_FEED_SPEED
+    mark = report_begin_field(rpt, "|FS:");
     if (report_inches->get()) {
-        sprintf(temp, "|FS:%.1f,%d", st_get_realtime_rate() / MM_PER_INCH, sys.spindle_speed);
+        rpt.append_fixed(st_get_realtime_rate() / MM_PER_INCH, 1);
     } else {
-        sprintf(temp, "|FS:%.0f,%d", st_get_realtime_rate(), sys.spindle_speed);
+        rpt.append_fixed(st_get_realtime_rate(), 0);
     }
-    strcat(status, temp);
+    rpt.append(',');
+    rpt.append_uint(sys.spindle_speed);
+    report_end_field(rpt, mark, ReportField::FeedSpeed, delta, keyframe);
 #endif
 #ifdef REPORT_FIELD_PIN_STATE
     AxisMask    lim_pin_state  = limits_get_state();
     ControlPins ctrl_pin_state = system_control_get_state();
     bool        prb_pin_state  = probe_get_state();
-    if (lim_pin_state || ctrl_pin_state.value || prb_pin_state) {
-        strcat(status, "|Pn:");
-        if (prb_pin_state) {
-            strcat(status, "P");
-        }
-        if (lim_pin_state) {
-            auto n_axis = number_axis->get();
-            if (n_axis >= 1 && bit_istrue(lim_pin_state, bit(X_AXIS))) {
-                strcat(status, "X");
-            }
-            if (n_axis >= 2 && bit_istrue(lim_pin_state, bit(Y_AXIS))) {
-                strcat(status, "Y");
-            }
-            if (n_axis >= 3 && bit_istrue(lim_pin_state, bit(Z_AXIS))) {
-                strcat(status, "Z");
-            }
-            if (n_axis >= 4 && bit_istrue(lim_pin_state, bit(A_AXIS))) {
-                strcat(status, "A");
-            }
-            if (n_axis >= 5 && bit_istrue(lim_pin_state, bit(B_AXIS))) {
-                strcat(status, "B");
-            }
-            if (n_axis >= 6 && bit_istrue(lim_pin_state, bit(C_AXIS))) {
-                strcat(status, "C");
+    mark                       = report_begin_field(rpt, "|Pn:");
+    if (prb_pin_state) {
+        rpt.append('P');
+    }
+    if (lim_pin_state) {
+        auto n_axis = number_axis->get();
+        for (uint8_t idx = 0; idx < n_axis; idx++) {
+            if (bit_istrue(lim_pin_state, bit(idx))) {
+                rpt.append(report_get_axis_letter(idx));
             }
         }
-        if (ctrl_pin_state.value) {
-            if (ctrl_pin_state.bit.safetyDoor) {
-                strcat(status, "D");
-            }
-            if (ctrl_pin_state.bit.reset) {
-                strcat(status, "R");
-            }
-            if (ctrl_pin_state.bit.feedHold) {
-                strcat(status, "H");
-            }
-            if (ctrl_pin_state.bit.cycleStart) {
-                strcat(status, "S");
-            }
-            if (ctrl_pin_state.bit.macro0) {
-                strcat(status, "0");
-            }
-            if (ctrl_pin_state.bit.macro1) {
-                strcat(status, "1");
-            }
-            if (ctrl_pin_state.bit.macro2) {
-                strcat(status, "2");
-            }
-            if (ctrl_pin_state.bit.macro3) {
-                strcat(status, "3");
-            }
+    }
+    if (ctrl_pin_state.value) {
+        if (ctrl_pin_state.bit.safetyDoor) {
+            rpt.append('D');
+        }
+        if (ctrl_pin_state.bit.reset) {
+            rpt.append('R');
+        }
+        if (ctrl_pin_state.bit.feedHold) {
+            rpt.append('H');
+        }
+        if (ctrl_pin_state.bit.cycleStart) {
+            rpt.append('S');
+        }
+        if (ctrl_pin_state.bit.macro0) {
+            rpt.append('0');
+        }
+        if (ctrl_pin_state.bit.macro1) {
+            rpt.append('1');
+        }
+        if (ctrl_pin_state.bit.macro2) {
+            rpt.append('2');
+        }
+        if (ctrl_pin_state.bit.macro3) {
+            rpt.append('3');
         }
     }
+    report_end_field(rpt, mark, ReportField::Pins, delta, keyframe);
 #endif
+    // Delta reports always consider WCO and overrides; unchanged values are dropped anyway.
 #ifdef REPORT_FIELD_WORK_COORD_OFFSET
-    if (sys.report_wco_counter > 0) {
-        sys.report_wco_counter--;
-    } else {
-        switch (sys.state) {
-            case State::Homing:
-            case State::Cycle:
-            case State::Hold:
-            case State::Jog:
-            case State::SafetyDoor:
-                sys.report_wco_counter = (REPORT_WCO_REFRESH_BUSY_COUNT - 1);  // Reset counter for slow refresh
-            default:
-                sys.report_wco_counter = (REPORT_WCO_REFRESH_IDLE_COUNT - 1);
-                break;
-        }
-        if (sys.report_ovr_counter == 0) {
-            sys.report_ovr_counter = 1;  // Set override on next report.
-        }
-        strcat(status, "|WCO:");
-        report_util_axis_values(get_wco(), temp);
-        strcat(status, temp);
+    if (delta || report_wco_due()) {
+        mark = report_begin_field(rpt, "|WCO:");
+        report_util_axis_values(get_wco(), rpt);
+        report_end_field(rpt, mark, ReportField::WorkCoordOffset, delta, keyframe);
     }
 #endif
 #ifdef REPORT_FIELD_OVERRIDES
-    if (sys.report_ovr_counter > 0) {
-        sys.report_ovr_counter--;
-    } else {
-        switch (sys.state) {
-            case State::Homing:
-            case State::Cycle:
-            case State::Hold:
-            case State::Jog:
-            case State::SafetyDoor:
-                sys.report_ovr_counter = (REPORT_OVR_REFRESH_BUSY_COUNT - 1);  // Reset counter for slow refresh
-            default:
-                sys.report_ovr_counter = (REPORT_OVR_REFRESH_IDLE_COUNT - 1);
-                break;
-        }
+    if (delta || report_ovr_due()) {
+        mark = report_begin_field(rpt, "|Ov:");
+        rpt.append_int(sys.f_override);
+        rpt.append(',');
+        rpt.append_int(sys.r_override);
+        rpt.append(',');
+        rpt.append_int(sys.spindle_speed_ovr);
+        report_end_field(rpt, mark, ReportField::Overrides, delta, keyframe);
 
-        sprintf(temp, "|Ov:%d,%d,%d", sys.f_override, sys.r_override, sys.spindle_speed_ovr);
-        strcat(status, temp);
         SpindleState sp_state      = spindle->get_state();
         CoolantState coolant_state = coolant_get_state();
-        if (sp_state != SpindleState::Disable || coolant_state.Mist || coolant_state.Flood) {
-            strcat(status, "|A:");
-            switch (sp_state) {
-                case SpindleState::Disable:
-                    break;
-                case SpindleState::Cw:
-                    strcat(status, "S");
-                    break;
-                case SpindleState::Ccw:
-                    strcat(status, "C");
-                    break;
-            }
+        mark                       = report_begin_field(rpt, "|A:");
+        switch (sp_state) {
+            case SpindleState::Disable:
+                break;
+            case SpindleState::Cw:
+                rpt.append('S');
+                break;
+            case SpindleState::Ccw:
+                rpt.append('C');
+                break;
+        }
 
-            auto coolant = coolant_state;
-            if (coolant.Flood) {
-                strcat(status, "F");
-            }
+        auto coolant = coolant_state;
+        if (coolant.Flood) {
+            rpt.append('F');
+        }
 #    ifdef COOLANT_MIST_PIN  // TODO Deal with M8 - Flood
-            if (coolant.Mist) {
-                strcat(status, "M");
-            }
-#    endif
+        if (coolant.Mist) {
+            rpt.append('M');
         }
+#    endif
+        report_end_field(rpt, mark, ReportField::Accessories, delta, keyframe);
     }
 #endif
 #ifdef ENABLE_SD_CARD
+    mark = report_begin_field(rpt, "|SD:");
     if (get_sd_state(false) == SDState::BusyPrinting) {
-        sprintf(temp, "|SD:%4.2f,", sd_report_perc_complete());
-        strcat(status, temp);
-        sd_get_current_filename(temp);
-        strcat(status, temp);
+        char filename[128];
+        rpt.append_fixed(sd_report_perc_complete(), 2);
+        rpt.append(',');
+        sd_get_current_filename(filename);
+        rpt.append(filename);
     }
+    report_end_field(rpt, mark, ReportField::SdProgress, delta, keyframe);
 #endif
 #ifdef REPORT_HEAP
-    sprintf(temp, "|Heap:%d", esp.getHeapSize());
-    strcat(status, temp);
+    mark = report_begin_field(rpt, "|Heap:");
+    rpt.append_int(esp.getHeapSize());
+    report_end_field(rpt, mark, ReportField::Heap, delta, keyframe);
 #endif
-    strcat(status, ">\r\n");
-    grbl_send(client, status);
+    rpt.release();
+    rpt.append(">\r\n");
+}
+
+// Prints real-time data. This function grabs a real-time snapshot of the stepper subprogram
+// and the actual location of the CNC machine. Users may change the following function to their
+// specific needs, but the desired real-time data report must be as short as possible. This is
+// requires as it minimizes the computational overhead and allows grbl to keep running smoothly,
+// especially during g-code programs with fast, short line segments and high frequency reports (5-20Hz).
+void report_realtime_status(uint8_t client) {
+    char          status[200];
+    ReportBuilder rpt(status, sizeof(status));
+    report_build_realtime_status(rpt, client);
+    client_write(client, rpt.c_str(), rpt.length());
+}
+
+// Push-mode status reports. A client that subscribes with $Report/Interval=<ms>
+// is sent a status report every <ms> milliseconds without having to poll with '?'.
+// A report identical to the last one pushed to that client is not sent again.
+static uint32_t report_interval_ms[CLIENT_COUNT] = { 0 };
+static uint32_t report_next_ms[CLIENT_COUNT]     = { 0 };
+static uint32_t report_last_hash[CLIENT_COUNT]   = { 0 };
+
+void report_set_status_interval(uint8_t client, uint32_t ms) {
+    report_interval_ms[client] = ms;
+    report_next_ms[client]     = millis();
+    report_last_hash[client]   = 0;  // Always send the first report after subscribing
+}
+
+uint32_t report_get_status_interval(uint8_t client) {
+    return report_interval_ms[client];
+}
+
+// Called periodically from clientCheckTask, so pushed reports never run
+// concurrently with reports requested by '?'.
+void report_realtime_status_push() {
+    uint32_t now = millis();
+    char     status[200];
+    for (uint8_t client = 0; client < CLIENT_COUNT; client++) {
+        if (report_interval_ms[client] == 0 || (int32_t)(now - report_next_ms[client]) < 0) {
+            continue;
+        }
+        report_next_ms[client] = now + report_interval_ms[client];
+        ReportBuilder rpt(status, sizeof(status));
+        report_build_realtime_status(rpt, client);
+        uint32_t hash = report_hash(rpt.c_str(), rpt.length());
+        if (hash != report_last_hash[client]) {
+            report_last_hash[client] = hash;
+            client_write(client, rpt.c_str(), rpt.length());
+        }
+    }
 }
 
 void report_realtime_steps() {
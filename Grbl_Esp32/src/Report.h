@@ -49,8 +49,9 @@ enum class Message : uint8_t {
 #define CLIENT_WEBUI 2
 #define CLIENT_TELNET 3
 #define CLIENT_INPUT 4
+#define CLIENT_TELNET2 5  // second telnet connection
 #define CLIENT_ALL 0xFF
-#define CLIENT_COUNT 5  // total number of client types regardless if they are used
+#define CLIENT_COUNT 6  // total number of client types regardless if they are used
 
 enum class MsgLevel : int8_t {  // Use $Message/Level
     None    = 0,
@@ -95,6 +96,15 @@ void report_echo_line_received(char* line, uint8_t client);
 // Prints realtime status report
 void report_realtime_status(uint8_t client);
 
+// Push-mode status reports, see $Report/Interval
+void     report_set_status_interval(uint8_t client, uint32_t ms);
+uint32_t report_get_status_interval(uint8_t client);
+void     report_realtime_status_push();
+
+// Delta status reports, see $Report/Delta
+void     report_set_delta_keyframe(uint8_t client, uint16_t interval);
+uint16_t report_get_delta_keyframe(uint8_t client);
+
 // Prints recorded probe position
 void report_probe_parameters(uint8_t client);
 
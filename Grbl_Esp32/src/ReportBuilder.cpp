@@ -0,0 +1,132 @@
+/*
+  ReportBuilder.cpp - appends report text into a fixed buffer
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ReportBuilder.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+void ReportBuilder::append(char c) {
+    if (_len + 1 < _limit) {
+        _buf[_len++] = c;
+        _buf[_len]   = '\0';
+    } else {
+        _overflowed = true;
+    }
+}
+
+void ReportBuilder::append(const char* text) {
+    append(text, strlen(text));
+}
+
+void ReportBuilder::append(const char* text, size_t len) {
+    if (_len + len >= _limit) {
+        len         = _len + 1 < _limit ? _limit - _len - 1 : 0;
+        _overflowed = true;
+    }
+    memcpy(_buf + _len, text, len);
+    _len += len;
+    _buf[_len] = '\0';
+}
+
+void ReportBuilder::append_uint(uint32_t value) {
+    char  digits[10];
+    char* p = digits + sizeof(digits);
+    do {
+        *--p = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    append(p, digits + sizeof(digits) - p);
+}
+
+void ReportBuilder::append_int(int32_t value) {
+    if (value < 0) {
+        append('-');
+        append_uint(0u - (uint32_t)value);
+    } else {
+        append_uint(value);
+    }
+}
+
+void ReportBuilder::append_fixed(float value, uint8_t decimals) {
+    static const uint32_t scale[] = { 1, 10, 100, 1000, 10000 };
+
+    if (decimals >= sizeof(scale) / sizeof(scale[0]) || !(fabsf(value) * scale[decimals] < 2e9f)) {  // also catches NaN
+        char text[24];
+        int  len = snprintf(text, sizeof(text), "%.*f", decimals, value);
+        append(text, len < (int)sizeof(text) ? len : sizeof(text) - 1);
+        return;
+    }
+
+    // The float is exactly mantissa * 2^exponent, so value * 10^decimals is computed
+    // exactly in integers and rounded half to even, which gives the digits printf does.
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool     negative = bits >> 31;
+    int      exponent = (bits >> 23) & 0xff;
+    uint64_t mantissa = bits & 0x7fffff;
+    if (exponent) {
+        mantissa |= 0x800000;
+    } else {
+        exponent = 1;  // Subnormal
+    }
+    int      shift  = exponent - 150;              // value = mantissa * 2^shift
+    uint64_t scaled = mantissa * scale[decimals];  // Less than 2^38
+    uint32_t mag;
+    if (shift >= 0) {
+        mag = scaled << shift;  // Below 2e9, by the range check above
+    } else if (shift > -64) {
+        uint64_t half      = 1ULL << (-shift - 1);
+        uint64_t remainder = scaled & ((half << 1) - 1);
+        mag                = scaled >> -shift;
+        if (remainder > half || (remainder == half && (mag & 1))) {
+            mag++;
+        }
+    } else {
+        mag = 0;
+    }
+
+    char  digits[16];
+    char* p = digits + sizeof(digits);
+    for (uint8_t i = 0; i < decimals; i++) {
+        *--p = '0' + mag % 10;
+        mag /= 10;
+    }
+    if (decimals) {
+        *--p = '.';
+    }
+    do {
+        *--p = '0' + mag % 10;
+        mag /= 10;
+    } while (mag);
+    if (negative) {
+        *--p = '-';  // printf keeps the sign of values that round to zero, and of -0
+    }
+    append(p, digits + sizeof(digits) - p);
+}
+
+void ReportBuilder::truncate(size_t len) {
+    if (len < _len) {
+        _len       = len;
+        _buf[_len] = '\0';
+    }
+    _overflowed = false;
+}
+
+void ReportBuilder::reserve(size_t len) {
+    _limit = len < _size ? _size - len : 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+/*
+  ReportBuilder.h - appends report text into a fixed buffer
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+// Builds a report in a caller-supplied buffer. The length is tracked, so appending
+// never rescans the string, and numbers are converted without printf or doubles.
+// Text that does not fit is dropped and marks the report as overflowed; the buffer
+// is always null terminated.
+class ReportBuilder {
+public:
+    ReportBuilder(char* buf, size_t size) : _buf(buf), _size(size), _limit(size), _len(0), _overflowed(false) { _buf[0] = '\0'; }
+
+    void append(char c);
+    void append(const char* text);
+    void append(const char* text, size_t len);
+    void append_int(int32_t value);
+    void append_uint(uint32_t value);
+    // Appends value rounded to the given number of decimal places (0-4), like "%.<decimals>f"
+    void append_fixed(float value, uint8_t decimals);
+
+    // Drops everything after the first len characters. What is left is complete, so
+    // this also clears the overflow.
+    void truncate(size_t len);
+
+    // Keeps the last len characters of the buffer out of use until release(), so a
+    // closing tail still fits after the report body overflows.
+    void reserve(size_t len);
+    void release() { _limit = _size; }
+
+    const char* c_str() const { return _buf; }
+    size_t      length() const { return _len; }
+    bool        overflowed() const { return _overflowed; }
+
+private:
+    char*  _buf;
+    size_t _size;
+    size_t _limit;  // _size less the reserved tail
+    size_t _len;
+    bool   _overflowed;
+};
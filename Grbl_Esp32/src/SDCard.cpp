@@ -21,14 +21,458 @@
 #include "Config.h"
 #ifdef ENABLE_SD_CARD
 #    include "SDCard.h"
+#    include <rom/miniz.h>
 
 File                       myFile;
-bool                       SD_ready_next = false;  // Grbl has processed a line and is waiting for another
-uint8_t                    SD_client     = CLIENT_SERIAL;
-WebUI::AuthenticationLevel SD_auth_level = WebUI::AuthenticationLevel::LEVEL_GUEST;
+bool                       SD_ready_next   = false;  // Grbl has processed a line and is waiting for another
+uint32_t                   SD_restart_line = 0;      // Line restartFile() replays the job up to, or 0
+uint8_t                    SD_client       = CLIENT_SERIAL;
+WebUI::AuthenticationLevel SD_auth_level   = WebUI::AuthenticationLevel::LEVEL_GUEST;
 uint32_t                   sd_current_line_number;     // stores the most recent line number read from the SD
 static char                comment[LINE_BUFFER_SIZE];  // Line to be executed. Zero-terminated.
 
+// A compiled sidecar starts with an sd_compiled_header_t naming the source it was made
+// from, followed by one record per source line. G-code lines are stored as the words
+// gc_tokenize_line() produced, so running the job skips text parsing. Lines that must go
+// through execute_line() as text (system commands, comments, malformed lines) are stored
+// verbatim.
+
+enum class SDRecord : uint8_t {
+    Text  = 'T',  // Length byte, then the raw line
+    Words = 'W',  // Word count, then a letter byte and a float for each word
+};
+
+static bool sd_compiled = false;  // myFile is a compiled sidecar rather than g-code text
+
+// Job files are read through two buffers. sdReadTask fills one from the card while the
+// protocol loop takes lines out of the other, so card latency overlaps with execution and
+// the FS layer is entered once per chunk instead of once per byte. Buffers travel between
+// the two sides as chunks on a pair of queues; only sdReadTask touches myFile while
+// chunks are in flight.
+typedef struct {
+    uint8_t index;  // Which of sd_buffer[] holds the data
+    size_t  len;    // Bytes read into it, 0 at the end of the file
+} sd_chunk_t;
+
+static TaskHandle_t  sdReadTaskHandle = NULL;
+static QueueHandle_t sd_free_queue;    // Buffers waiting to be filled
+static QueueHandle_t sd_filled_queue;  // Buffers holding data, in file order
+static uint8_t*      sd_buffer[2];
+static sd_chunk_t    sd_front;      // Chunk being consumed
+static size_t        sd_front_pos;  // Next unread byte in sd_front
+static uint32_t      sd_offset;     // File position of the next unread byte
+static uint32_t      sd_file_size;  // Cached so the protocol loop does not query myFile
+static uint8_t       sd_in_flight = 0;  // Chunks handed to sdReadTask and not yet taken back
+static bool          sd_streaming = false;
+static bool          sd_eof       = false;
+static bool          sd_failed    = false;  // The file could not be read to the end
+
+static void sd_index_write_queued();
+
+static void sdReadTask(void* pvParameters) {
+    sd_chunk_t chunk;
+    while (true) {
+        xQueueReceive(sd_free_queue, &chunk, portMAX_DELAY);
+        sd_index_write_queued();  // Checkpoints reached since the last read
+        chunk.len = myFile.read(sd_buffer[chunk.index], SD_READ_BUFFER_SIZE);
+        xQueueSend(sd_filled_queue, &chunk, portMAX_DELAY);
+    }
+}
+
+// Hands both buffers to sdReadTask, starting from the current position of myFile.
+static bool sd_stream_start() {
+    if (sdReadTaskHandle == NULL) {
+        sd_buffer[0] = (uint8_t*)malloc(SD_READ_BUFFER_SIZE);
+        sd_buffer[1] = (uint8_t*)malloc(SD_READ_BUFFER_SIZE);
+        if (sd_buffer[0] == NULL || sd_buffer[1] == NULL) {
+            free(sd_buffer[0]);
+            free(sd_buffer[1]);
+            sd_buffer[0] = sd_buffer[1] = NULL;
+            return false;
+        }
+        sd_free_queue   = xQueueCreate(2, sizeof(sd_chunk_t));
+        sd_filled_queue = xQueueCreate(2, sizeof(sd_chunk_t));
+        xTaskCreatePinnedToCore(sdReadTask,    // task
+                                "sdReadTask",  // name for task
+                                4096,          // size of task stack
+                                NULL,          // parameters
+                                1,             // priority
+                                &sdReadTaskHandle,
+                                SUPPORT_TASK_CORE  // core
+        );
+    }
+    sd_offset    = myFile.position();
+    sd_front     = { 0, 0 };
+    sd_front_pos = 0;
+    sd_eof       = false;
+    sd_streaming = true;
+    for (uint8_t i = 0; i < 2; i++) {
+        sd_chunk_t chunk = { i, 0 };
+        xQueueSend(sd_free_queue, &chunk, portMAX_DELAY);
+        sd_in_flight++;
+    }
+    return true;
+}
+
+// Waits for sdReadTask to finish any read in progress, after which myFile may be closed.
+static void sd_stream_stop() {
+    sd_chunk_t chunk;
+    while (sd_in_flight) {
+        xQueueReceive(sd_filled_queue, &chunk, portMAX_DELAY);
+        sd_in_flight--;
+    }
+    sd_front     = { 0, 0 };
+    sd_front_pos = 0;
+    sd_streaming = false;
+}
+
+// Makes sure sd_front has unread data, waiting for the next chunk if it is used up.
+// Returns false at the end of the file.
+static bool sd_stream_fill() {
+    if (sd_front_pos < sd_front.len) {
+        return true;
+    }
+    if (!sd_streaming && !sd_stream_start()) {
+        sd_failed = true;
+        return false;
+    }
+    while (!sd_eof && sd_in_flight) {
+        if (sd_front.len) {
+            sd_front.len = 0;
+            xQueueSend(sd_free_queue, &sd_front, portMAX_DELAY);  // Refill the buffer just used up
+            sd_in_flight++;
+        }
+        xQueueReceive(sd_filled_queue, &sd_front, portMAX_DELAY);
+        sd_in_flight--;
+        sd_front_pos = 0;
+        if (sd_front.len) {
+            return true;
+        }
+        sd_eof = true;
+    }
+    return false;
+}
+
+// Copies up to len bytes of the file to data and returns the number copied.
+static size_t sd_stream_read(uint8_t* data, size_t len) {
+    size_t copied = 0;
+    while (copied < len && sd_stream_fill()) {
+        size_t n = min(len - copied, sd_front.len - sd_front_pos);
+        memcpy(data + copied, sd_buffer[sd_front.index] + sd_front_pos, n);
+        sd_front_pos += n;
+        sd_offset += n;
+        copied += n;
+    }
+    return copied;
+}
+
+// Files ending in SD_GZIP_SUFFIX are inflated as they are read, with the miniz inflater
+// in the ESP32 ROM. The inflater writes into a window the size of the deflate
+// dictionary, wrapping around, and the parser reads lines straight out of it.
+typedef struct {
+    tinfl_decompressor inflator;
+    uint8_t            window[TINFL_LZ_DICT_SIZE];
+} sd_gzip_t;
+
+static sd_gzip_t* sd_gzip = NULL;  // Allocated while a compressed file is open
+static size_t     sd_gzip_out;     // Where the inflater writes next in the window
+static size_t     sd_gzip_pos;     // Next unread byte in the window
+static size_t     sd_gzip_avail;   // Unread bytes from sd_gzip_pos, never wrapping
+static bool       sd_gzip_started;
+static bool       sd_gzip_done;
+
+static bool sd_is_gzip(const char* path) {
+    size_t len = strlen(path);
+    return len > strlen(SD_GZIP_SUFFIX) && strcasecmp(path + len - strlen(SD_GZIP_SUFFIX), SD_GZIP_SUFFIX) == 0;
+}
+
+static bool sd_gzip_open() {
+    if (sd_gzip == NULL) {
+        sd_gzip = (sd_gzip_t*)(psramFound() ? ps_malloc(sizeof(sd_gzip_t)) : malloc(sizeof(sd_gzip_t)));
+        if (sd_gzip == NULL) {
+            return false;
+        }
+    }
+    tinfl_init(&sd_gzip->inflator);
+    sd_gzip_out     = 0;
+    sd_gzip_pos     = 0;
+    sd_gzip_avail   = 0;
+    sd_gzip_started = false;
+    sd_gzip_done    = false;
+    return true;
+}
+
+static void sd_gzip_close() {
+    free(sd_gzip);
+    sd_gzip = NULL;
+}
+
+// Skips the gzip member header (RFC 1952), leaving the raw deflate data next.
+static bool sd_gzip_skip_header() {
+    uint8_t header[10];
+    uint8_t byte;
+    if (sd_stream_read(header, sizeof(header)) != sizeof(header) || header[0] != 0x1f || header[1] != 0x8b || header[2] != 8) {
+        return false;
+    }
+    uint8_t flags = header[3];
+    if (flags & 0x04) {  // FEXTRA: length, then that many bytes
+        uint8_t xlen[2];
+        if (sd_stream_read(xlen, sizeof(xlen)) != sizeof(xlen)) {
+            return false;
+        }
+        for (size_t skip = xlen[0] | (xlen[1] << 8); skip; skip--) {
+            if (!sd_stream_read(&byte, 1)) {
+                return false;
+            }
+        }
+    }
+    for (uint8_t field = 0x08; field <= 0x10; field <<= 1) {  // FNAME and FCOMMENT, NUL terminated
+        if (flags & field) {
+            do {
+                if (!sd_stream_read(&byte, 1)) {
+                    return false;
+                }
+            } while (byte);
+        }
+    }
+    if (flags & 0x02) {  // FHCRC
+        uint8_t crc[2];
+        return sd_stream_read(crc, sizeof(crc)) == sizeof(crc);
+    }
+    return true;
+}
+
+// Inflates more of the file once everything inflated so far has been read. Returns
+// the unread bytes, or 0 at the end of the data. The gzip trailer is not checked.
+static size_t sd_gzip_peek(const uint8_t** data) {
+    if (!sd_gzip_started) {
+        sd_gzip_started = true;
+        if (!sd_gzip_skip_header()) {
+            sd_failed    = true;
+            sd_gzip_done = true;
+        }
+    }
+    while (sd_gzip_avail == 0 && !sd_gzip_done) {
+        bool           more    = sd_stream_fill();
+        const uint8_t* in      = sd_buffer[sd_front.index] + sd_front_pos;
+        size_t         in_len  = more ? sd_front.len - sd_front_pos : 0;
+        size_t         out_len = TINFL_LZ_DICT_SIZE - sd_gzip_out;
+        tinfl_status   status  = tinfl_decompress(&sd_gzip->inflator,
+                                               in,
+                                               &in_len,
+                                               sd_gzip->window,
+                                               sd_gzip->window + sd_gzip_out,
+                                               &out_len,
+                                               more ? TINFL_FLAG_HAS_MORE_INPUT : 0);
+        sd_front_pos += in_len;
+        sd_offset += in_len;  // Progress follows the compressed data
+        sd_gzip_pos   = sd_gzip_out;
+        sd_gzip_avail = out_len;
+        sd_gzip_out   = (sd_gzip_out + out_len) & (TINFL_LZ_DICT_SIZE - 1);
+        if (status == TINFL_STATUS_DONE) {
+            sd_gzip_done = true;
+        } else if (status < TINFL_STATUS_DONE) {
+            sd_failed    = true;  // Corrupt or truncated
+            sd_gzip_done = true;
+        }
+    }
+    *data = sd_gzip->window + sd_gzip_pos;
+    return sd_gzip_avail;
+}
+
+// The unread bytes of the job as the parser sees them, inflated if the file is
+// compressed. Returns 0 at the end of the file.
+static size_t sd_peek(const uint8_t** data) {
+    if (sd_gzip) {
+        return sd_gzip_peek(data);
+    }
+    if (!sd_stream_fill()) {
+        return 0;
+    }
+    *data = sd_buffer[sd_front.index] + sd_front_pos;
+    return sd_front.len - sd_front_pos;
+}
+
+// Marks len bytes returned by sd_peek() as read.
+static void sd_consume(size_t len) {
+    if (sd_gzip) {
+        sd_gzip_pos += len;
+        sd_gzip_avail -= len;
+    } else {
+        sd_front_pos += len;
+        sd_offset += len;
+    }
+}
+
+// Copies up to len bytes of the job to data and returns the number copied.
+static size_t sd_read(uint8_t* data, size_t len) {
+    const uint8_t* avail;
+    size_t         copied = 0;
+    size_t         n;
+    while (copied < len && (n = sd_peek(&avail)) > 0) {
+        n = min(n, len - copied);
+        memcpy(data + copied, avail, n);
+        sd_consume(n);
+        copied += n;
+    }
+    return copied;
+}
+
+// Running a job keeps a sidecar index next to the file it reads, holding a checkpoint
+// every SD_INDEX_INTERVAL lines: the byte offset where the line starts and the parser
+// state just before it runs. seekFileLine() uses it to restart a job part way through
+// without reading everything before the restart line. Checkpoints are appended as lines
+// are reached, so a job that stopped early still has an index up to where it stopped.
+// The protocol loop only queues each checkpoint; sdReadTask writes it to the card
+// between reads, and whoever stops the stream writes what is left.
+static const uint32_t SD_INDEX_MAGIC      = 0x33494347;  // "GCI3"
+static const int      SD_INDEX_QUEUE_SIZE = 4;           // Checkpoints waiting for sdReadTask
+
+typedef struct {
+    uint32_t magic;
+    uint32_t size;        // Size of the indexed file
+    uint32_t last_write;  // Modification time of the indexed file
+    uint32_t hash;        // Of its contents, as an edit can leave its size and time unchanged
+    uint32_t entry_size;  // Changes when parser_state_t does
+} sd_index_header_t;
+
+// The parts of gc_state a checkpoint restores. Positions and work offsets are left out;
+// they belong to the machine as it is now, not as it was when the job passed the line.
+typedef struct {
+    uint32_t    line;         // Line about to run, counting from 1
+    uint32_t    offset;       // Where that line starts in the file
+    uint32_t    definitions;  // Where the last subroutine definition before it ends, 0 if none
+    gc_modal_t  modal;        // The rest is gc_state before that line
+    float       spindle_speed;
+    float       feed_rate;
+    uint8_t     tool;
+    gc_canned_t canned;  // R, Z, Q and P of a drilling cycle that is still active
+} sd_index_entry_t;
+
+static fs::FS*       sd_index_fs = NULL;  // Indexing is off when NULL
+static String        sd_index_path;
+static File          sd_index;            // Opened for appending at the first new checkpoint, written only by sd_index_write_queued()
+static uint32_t      sd_index_next_line;  // Line of the next checkpoint to append
+static uint32_t      sd_definitions_end;  // Where the last subroutine definition read so far ends
+static QueueHandle_t sd_index_queue = NULL;  // Checkpoints waiting to be written
+static volatile bool sd_index_failed;        // A checkpoint could not be written
+
+// Prepares the index of a job that has just been opened, whose contents hash to hash,
+// starting a new one if there is none or it no longer matches the file.
+static void sd_index_open(fs::FS& fs, const String& job_path, uint32_t hash) {
+    sd_index_header_t expected = {
+        SD_INDEX_MAGIC, uint32_t(myFile.size()), uint32_t(myFile.getLastWrite()), hash, sizeof(sd_index_entry_t)
+    };
+    sd_index_header_t header;
+    sd_index_entry_t  entry;
+    sd_index_fs        = NULL;
+    sd_index_path      = job_path + SD_INDEX_SUFFIX;
+    sd_index_next_line = 1;
+    sd_index_failed    = false;
+    File index         = fs.open(sd_index_path);
+    if (sd_index_queue == NULL) {
+        sd_index_queue = xQueueCreate(SD_INDEX_QUEUE_SIZE, sizeof(sd_index_entry_t));
+    }
+    if (index && index.read((uint8_t*)&header, sizeof(header)) == sizeof(header) && memcmp(&header, &expected, sizeof(header)) == 0 &&
+        (index.size() - sizeof(header)) % sizeof(entry) == 0) {
+        if (index.size() > sizeof(header) && index.seek(index.size() - sizeof(entry)) &&
+            index.read((uint8_t*)&entry, sizeof(entry)) == sizeof(entry)) {
+            sd_index_next_line = entry.line + SD_INDEX_INTERVAL;
+        }
+        index.close();
+        sd_index_fs = &fs;
+        return;
+    }
+    index.close();
+    index = fs.open(sd_index_path, FILE_WRITE);  // Missing, stale or torn by a power loss
+    markSDChanged();
+    if (index && index.write((uint8_t*)&expected, sizeof(expected)) == sizeof(expected)) {
+        sd_index_fs = &fs;
+    }
+    index.close();
+}
+
+// Writes the checkpoints waiting in sd_index_queue. Called by sdReadTask, or with the
+// stream stopped.
+static void sd_index_write_queued() {
+    sd_index_entry_t entry;
+    while (sd_index_queue && xQueueReceive(sd_index_queue, &entry, 0)) {
+        if (sd_index_failed) {
+            continue;
+        }
+        if (!sd_index) {
+            sd_index = sd_index_fs->open(sd_index_path, FILE_APPEND);
+        }
+        if (!sd_index || sd_index.write((uint8_t*)&entry, sizeof(entry)) != sizeof(entry)) {
+            sd_index.close();  // A torn entry makes the next run start a new index
+            sd_index_failed = true;
+        }
+    }
+}
+
+// Writes what is still queued and closes the index of the job being left.
+static void sd_index_flush() {
+    if (sd_streaming) {
+        sd_stream_stop();
+    }
+    if (sd_index_fs) {
+        sd_index_write_queued();
+    }
+    sd_index.close();
+}
+
+// Queues a checkpoint if the next line to run is due one.
+static void sd_index_checkpoint() {
+    uint32_t line = sd_current_line_number + 1;
+    if (sd_index_fs == NULL || sd_index_failed || line < sd_index_next_line || gc_recording_subroutine()) {
+        return;
+    }
+    sd_index_entry_t entry;
+    entry.line          = line;
+    entry.offset        = sd_offset;
+    entry.definitions   = sd_definitions_end;
+    entry.modal         = gc_state.modal;
+    entry.spindle_speed = gc_state.spindle_speed;
+    entry.feed_rate     = gc_state.feed_rate;
+    entry.tool          = gc_state.tool;
+    entry.canned        = gc_state.canned;
+    if (xQueueSend(sd_index_queue, &entry, 0) == pdTRUE) {  // If full, the next line tries again
+        markSDChanged();
+        sd_index_next_line = line + SD_INDEX_INTERVAL;
+    }
+}
+
+// Finds the last checkpoint at or before line.
+static bool sd_index_find(uint32_t line, sd_index_entry_t* entry) {
+    if (sd_index_fs == NULL) {
+        return false;
+    }
+    File index = sd_index_fs->open(sd_index_path);
+    if (!index) {
+        return false;
+    }
+    // Checkpoints are in line order; find how many are at or before line
+    sd_index_entry_t probe;
+    uint32_t         low  = 0;
+    uint32_t         high = (index.size() - sizeof(sd_index_header_t)) / sizeof(sd_index_entry_t);
+    while (low < high) {
+        uint32_t mid = (low + high) / 2;
+        if (!(index.seek(sizeof(sd_index_header_t) + mid * sizeof(probe)) &&
+              index.read((uint8_t*)&probe, sizeof(probe)) == sizeof(probe))) {
+            break;
+        }
+        if (probe.line <= line) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    bool found = low > 0 && index.seek(sizeof(sd_index_header_t) + (low - 1) * sizeof(*entry)) &&
+                 index.read((uint8_t*)entry, sizeof(*entry)) == sizeof(*entry);
+    index.close();
+    return found;
+}
+
 // attempt to mount the SD card
 /*bool sd_mount()
 {
@@ -63,15 +507,441 @@ void listDir(fs::FS& fs, const char* dirname, uint8_t levels, uint8_t client) {
     }
 }
 
+// The last SD directory listed, packed as a uint32_t size (SD_LIST_DIR for a directory)
+// followed by the NUL-terminated name of each entry, in directory order
+static const uint32_t SD_LIST_DIR = 0xFFFFFFFF;
+
+static char*    sd_list_cache = NULL;  // Empty when NULL
+static size_t   sd_list_len;
+static String   sd_list_path;
+static uint32_t sd_list_generation;  // sd_generation when listed
+
+// Counts changes to the card. Every path that creates, writes, or removes something on
+// it calls markSDChanged(), as do a mount that may have found another card and a change
+// of the card detect pin, so a listing cached under an older generation is known to be stale.
+static uint32_t      sd_generation     = 0;
+static uint64_t      sd_card_size      = 0;      // Size of the card last mounted
+static volatile bool sd_detect_changed = false;  // The card detect pin changed since sd_check_detect()
+
+void markSDChanged() {
+    sd_generation++;
+}
+
+// A card can be pulled out and another put in between two reads of the detect pin, so
+// every change of the pin is caught as it happens
+static void IRAM_ATTR isr_sd_detect() {
+    sd_detect_changed = true;
+}
+
+// Marks the card changed if its detect pin has changed, watching the pin from the first call
+static void sd_check_detect() {
+    static bool watching = false;
+    if (SDCARD_DET_PIN == UNDEFINED_PIN) {
+        return;
+    }
+    if (!watching) {
+        attachInterrupt(SDCARD_DET_PIN, isr_sd_detect, CHANGE);
+        watching = true;
+        markSDChanged();  // Whatever happened before the pin was watched
+    }
+    if (sd_detect_changed) {
+        sd_detect_changed = false;
+        markSDChanged();
+    }
+}
+
+// True when the listing of path can be paged without reading the card, or even mounting it
+bool isDirCached(const char* path) {
+    sd_check_detect();
+    return sd_list_cache && sd_list_path == path && sd_list_generation == sd_generation;
+}
+
+// Directories always match, so they can still be opened while filtering
+static bool sd_list_match(const char* name, uint32_t size, const char* filter) {
+    if (size == SD_LIST_DIR || filter == NULL || *filter == '\0') {
+        return true;
+    }
+    size_t len = strlen(filter);
+    for (; *name; name++) {
+        if (strncasecmp(name, filter, len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The cache is kept in PSRAM when there is some. Internal RAM is only held while a
+// listing is paged through, and is given back once its last page has been listed.
+static void sd_list_page_done(uint32_t offset, uint32_t limit, uint32_t matched) {
+    if (!psramFound() && (limit >= matched || offset >= matched - limit)) {
+        free(sd_list_cache);
+        sd_list_cache = NULL;
+    }
+}
+
+// Lists the entries of an SD directory whose names contain filter, ignoring case,
+// calling each() for those from offset up to limit of them. Returns how many match.
+uint32_t listDirPage(const char* path, const char* filter, uint32_t offset, uint32_t limit, sd_list_cb_t each) {
+    uint32_t matched = 0;
+    auto     visit   = [&](const char* name, uint32_t size) {
+        if (sd_list_match(name, size, filter)) {
+            if (matched >= offset && matched - offset < limit) {
+                each(name, size == SD_LIST_DIR, size == SD_LIST_DIR ? 0 : size);
+            }
+            matched++;
+        }
+    };
+
+    if (isDirCached(path)) {
+        for (size_t pos = 0; pos < sd_list_len;) {
+            uint32_t size;
+            memcpy(&size, sd_list_cache + pos, sizeof(size));
+            const char* name = sd_list_cache + pos + sizeof(size);
+            visit(name, size);
+            pos += sizeof(size) + strlen(name) + 1;
+        }
+        sd_list_page_done(offset, limit, matched);
+        return matched;
+    }
+
+    // Read the directory, keeping a copy if it fits
+    free(sd_list_cache);
+    sd_list_cache = NULL;
+    File dir = SD.open(path);
+    if (!dir || !dir.isDirectory()) {
+        return 0;
+    }
+    char*    cache   = (char*)(psramFound() ? ps_malloc(SD_LIST_CACHE_SIZE) : malloc(SD_LIST_CACHE_SIZE));
+    size_t   len     = 0;
+    uint32_t entries = 0;
+    File     entry   = dir.openNextFile();
+    while (entry) {
+        const char* name = strrchr(entry.name(), '/');
+        name             = name ? name + 1 : entry.name();
+        uint32_t size    = entry.isDirectory() ? SD_LIST_DIR : entry.size();
+        visit(name, size);
+        size_t need = sizeof(size) + strlen(name) + 1;
+        if (cache && len + need <= SD_LIST_CACHE_SIZE) {
+            memcpy(cache + len, &size, sizeof(size));
+            strcpy(cache + len + sizeof(size), name);
+            len += need;
+        } else {
+            free(cache);
+            cache = NULL;
+        }
+        entry.close();
+        entry = dir.openNextFile();
+        if (++entries % 32 == 0) {
+            vTaskDelay(1);  // Let the idle task run during a long scan
+        }
+    }
+    dir.close();
+    if (cache) {
+        sd_list_cache      = cache;
+        sd_list_len        = len;
+        sd_list_path       = path;
+        sd_list_generation = sd_generation;
+        sd_list_page_done(offset, limit, matched);
+    }
+    return matched;
+}
+
 boolean openFile(fs::FS& fs, const char* path) {
-    myFile = fs.open(path);
-    if (!myFile) {
+    File file = fs.open(path);
+    if (!file) {
         //report_status_message(Error::FsFailedRead, CLIENT_SERIAL);
-        return false;
+        return false;  // Any file already open stays open
     }
+    sd_index_flush();
+    sd_index_fs = NULL;
+    myFile      = file;
     set_sd_state(SDState::BusyPrinting);
     SD_ready_next          = false;  // this will get set to true when Grbl issues "ok" message
+    SD_restart_line        = 0;
     sd_current_line_number = 0;
+    sd_compiled            = false;
+    sd_file_size           = myFile.size();
+    sd_offset              = 0;
+    sd_definitions_end     = 0;
+    sd_failed              = false;
+    sd_gzip_close();
+    if (sd_is_gzip(path) && !sd_gzip_open()) {
+        closeFile();
+        return false;
+    }
+    return true;
+}
+
+static uint32_t sd_hash(const uint8_t* data, size_t len, uint32_t hash = 2166136261u) {
+    while (len--) {
+        hash = (hash ^ *data++) * 16777619u;
+    }
+    return hash;
+}
+
+// Hashes the whole of file, a block at a time, giving other tasks a turn between groups
+// of blocks. Returns false if it cannot be read to the end.
+static bool sd_hash_file(File& file, uint32_t* hash) {
+    uint8_t  block[512];
+    uint32_t blocks = 0;
+    size_t   total  = 0;
+    size_t   n;
+    *hash = sd_hash(NULL, 0);
+    while ((n = file.read(block, sizeof(block))) > 0) {
+        *hash = sd_hash(block, n, *hash);
+        total += n;
+        if (++blocks % 8 == 0) {
+            vTaskDelay(1);
+        }
+    }
+    return total == file.size();
+}
+
+// Opens a file to run as a job. If it has a compiled sidecar whose header still
+// matches the file, the sidecar is opened instead. Size and modification time are
+// checked first, then the contents, as a card without a clock can leave the time of
+// an edited file unchanged. A file run as it is is hashed for its restart index.
+boolean openJobFile(fs::FS& fs, const char* path) {
+    String compiled_path = String(path) + SD_COMPILED_SUFFIX;
+    if (fs.exists(compiled_path)) {
+        sd_compiled_header_t header;
+        uint32_t             hash;
+        File                 source   = fs.open(path);
+        File                 compiled = fs.open(compiled_path);
+        bool current = source && compiled && compiled.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                       header.magic == SD_COMPILED_MAGIC && header.source_size == source.size() &&
+                       header.source_mtime == uint32_t(source.getLastWrite()) && sd_hash_file(source, &hash) &&
+                       header.source_hash == hash;
+        source.close();
+        compiled.close();
+        if (current && openFile(fs, compiled_path.c_str())) {
+            myFile.seek(sizeof(header));
+            sd_offset   = sizeof(header);
+            sd_compiled = true;
+            sd_index_open(fs, compiled_path, sd_hash((uint8_t*)&header, sizeof(header)));  // Holds the hash of the source
+            return true;
+        }
+    }
+    if (!openFile(fs, path)) {
+        return false;
+    }
+    if (!sd_gzip) {
+        uint32_t hash;
+        if (!sd_hash_file(myFile, &hash) || !myFile.seek(0)) {
+            closeFile();
+            return false;  // It cannot be read to the end
+        }
+        sd_index_open(fs, path, hash);  // A deflate stream cannot be entered part way through
+    }
+    return true;
+}
+
+// What sd_next_line() found
+enum class SDLine : uint8_t {
+    End,     // The end of the file
+    Text,    // A line of text
+    Words,   // A g-code block from a compiled sidecar
+    Failed,  // A read error, or a truncated or corrupt sidecar
+};
+
+// Reads the next line of the running job, from text or from a compiled sidecar.
+static SDLine sd_next_line(char* line, gc_words_t* words) {
+    if (!sd_compiled) {
+        if (!readFileLine(line, SD_LINE_MAX)) {
+            return sd_failed ? SDLine::Failed : SDLine::End;
+        }
+        return SDLine::Text;
+    }
+    uint8_t header[2] = {};  // Record type and length
+    size_t  header_len = sd_read(header, sizeof(header));
+    if (header_len == 0 && !sd_failed) {
+        return SDLine::End;
+    }
+    sd_current_line_number += 1;
+    int type  = header[0];
+    int count = header_len == sizeof(header) ? header[1] : -1;
+    if (type == int(SDRecord::Text) && count >= 0 && sd_read((uint8_t*)line, count) == size_t(count)) {
+        line[count] = '\0';
+        return SDLine::Text;
+    }
+    if (type == int(SDRecord::Words) && count >= 0 && count <= MAX_GCODE_WORDS) {
+        uint8_t record[MAX_GCODE_WORDS * (1 + sizeof(float))];
+        size_t  record_len = count * (1 + sizeof(float));
+        if (sd_read(record, record_len) == record_len) {
+            words->jog   = false;
+            words->error = Error::Ok;
+            words->count = count;
+            for (uint8_t i = 0; i < words->count; i++) {
+                words->word[i].letter = record[i * (1 + sizeof(float))];
+                memcpy(&words->word[i].value, record + i * (1 + sizeof(float)) + 1, sizeof(float));
+            }
+            return SDLine::Words;
+        }
+    }
+    return SDLine::Failed;
+}
+
+// Moves the read position of the running job to offset, at the start of a line.
+static void sd_seek(uint32_t offset) {
+    if (sd_streaming) {
+        sd_stream_stop();
+    }
+    myFile.seek(offset);
+    sd_offset = offset;
+}
+
+// True for the O-word lines that open and close a subroutine definition
+static bool sd_is_definition(const char* line) {
+    char block[LINE_BUFFER_SIZE];
+    strcpy(block, line);
+    collapseGCode(block);
+    size_t len = strlen(block);
+    return block[0] == 'O' && len > 3 && strcmp(block + len - 3, "SUB") == 0;  // O<n>SUB or O<n>ENDSUB
+}
+
+// Runs the subroutine definitions in the part of the job before offset again, as a
+// restart from a checkpoint after them skips them. Other lines are only read.
+static void sd_replay_definitions(uint32_t offset) {
+    static gc_words_t words;
+    char              line[LINE_BUFFER_SIZE];
+    sd_seek(sd_compiled ? sizeof(sd_compiled_header_t) : 0);
+    while (sd_offset < offset && !sys.abort) {
+        SDLine found = sd_next_line(line, &words);
+        if (found == SDLine::Text && (gc_recording_subroutine() || sd_is_definition(line))) {
+            execute_line(line, SD_client, SD_auth_level);
+        } else if (found == SDLine::Words && gc_recording_subroutine()) {
+            execute_block(&words, SD_client);
+        } else if (found == SDLine::End || found == SDLine::Failed) {
+            return;
+        }
+    }
+}
+
+// Positions a job just opened with openJobFile() so that the next line executed is
+// line, with the parser in the state it had when the job last reached that line. The
+// modal and canned cycle state of the nearest checkpoint at or before it is restored
+// directly, and the subroutines defined before the checkpoint are defined again. Then
+// the lines after the checkpoint are replayed in check mode, which updates the parser
+// without moving the machine. Returns false if the file ends first.
+boolean seekFileLine(uint32_t line) {
+    sd_index_entry_t entry;
+    State            saved_state = sys.state;
+    sys.state                    = State::CheckMode;
+    sd_index_flush();
+    if (sd_index_find(line, &entry)) {
+        if (entry.definitions) {
+            sd_replay_definitions(entry.definitions);
+        }
+        sd_seek(entry.offset);
+        sd_current_line_number = entry.line - 1;
+        gc_state.modal         = entry.modal;
+        gc_state.spindle_speed = entry.spindle_speed;
+        gc_state.feed_rate     = entry.feed_rate;
+        gc_state.tool          = entry.tool;
+        gc_state.canned        = entry.canned;
+        coords[gc_state.modal.coord_select]->get(gc_state.coord_system);  // The offsets as they are now
+        system_flag_wco_change();
+    }
+    bool  more = true;
+    Error status;
+    while (more && sd_current_line_number + 1 < line && !sys.abort) {
+        more = executeFileLine(&status);
+    }
+    sys.state                   = saved_state;
+    gc_state.modal.program_flow = ProgramFlow::Running;
+    gc_sync_position();  // Replayed moves only moved the parser
+    return more;
+}
+
+// Restarts the open job at SD_restart_line, then turns the spindle and coolant to what
+// the restored modal state says they are. [ESP220] only sets the line; the protocol loop
+// calls this before the job's next line, because seekFileLine() puts the whole machine
+// in check mode and a line from another client must not be parsed meanwhile.
+boolean restartFile() {
+    uint32_t line   = SD_restart_line;
+    SD_restart_line = 0;
+    if (!seekFileLine(line)) {
+        return false;
+    }
+    spindle->sync(gc_state.modal.spindle, uint32_t(gc_state.spindle_speed));
+    coolant_sync(gc_state.modal.coolant);
+    return true;
+}
+
+// Jobs waiting to run, in order. queueRun() opens the first. When a queued job reaches
+// the end of its file, openNextQueuedFile() opens the next in the same pass of the main
+// loop, so its first lines are planned while the last moves of the previous job run.
+static String  sd_queue[SD_QUEUE_SIZE];
+static uint8_t sd_queue_count   = 0;
+static bool    sd_queue_running = false;  // The running job came from the queue
+static bool    sd_queue_gate    = false;  // Hold before each job after the first, like M0
+
+Error queueAddFile(fs::FS& fs, const char* path) {
+    if (sd_queue_count >= SD_QUEUE_SIZE) {
+        return Error::Overflow;
+    }
+    File file = fs.open(path);
+    if (!file || file.isDirectory()) {
+        return Error::FsFileNotFound;
+    }
+    file.close();
+    sd_queue[sd_queue_count++] = path;
+    return Error::Ok;
+}
+
+void queueClear() {
+    while (sd_queue_count) {
+        sd_queue[--sd_queue_count] = String();
+    }
+}
+
+uint8_t queueCount() {
+    return sd_queue_count;
+}
+
+const char* queueFile(uint8_t index) {
+    return index < sd_queue_count ? sd_queue[index].c_str() : "";
+}
+
+// Takes jobs off the front of the queue until one opens.
+static bool sd_queue_open_next(fs::FS& fs) {
+    while (sd_queue_count) {
+        String path = sd_queue[0];
+        for (uint8_t i = 1; i < sd_queue_count; i++) {
+            sd_queue[i - 1] = sd_queue[i];
+        }
+        sd_queue[--sd_queue_count] = String();
+        if (openJobFile(fs, path.c_str())) {
+            sd_queue_running = true;
+            return true;
+        }
+        grbl_msg_sendf(CLIENT_ALL, MsgLevel::Error, "Cannot open queued file %s", path.c_str());
+    }
+    return false;
+}
+
+// Opens the first queued job. With gate, each later job waits in a feed hold until
+// cycle start, so parts can be changed between jobs.
+boolean queueRun(fs::FS& fs, bool gate) {
+    sd_queue_gate = gate;
+    return sd_queue_open_next(fs);
+}
+
+// Called when the running job has reached the end of its file. Returns false, leaving
+// the job to be closed, unless it came from the queue and another queued job opened.
+boolean openNextQueuedFile() {
+    if (!sd_queue_running || !sd_queue_open_next(SD)) {
+        return false;
+    }
+    SD_ready_next = true;
+    if (sd_queue_gate) {
+        char name[128];
+        sd_get_current_filename(name);
+        grbl_msg_sendf(CLIENT_ALL, MsgLevel::Info, "Queue holding before %s, cycle start to run it", name);
+        protocol_buffer_synchronize();  // Let the previous job finish, as M0 does
+        sys_rt_exec_state.bit.feedHold = true;
+        protocol_execute_realtime();
+    }
     return true;
 }
 
@@ -81,7 +951,14 @@ boolean closeFile() {
     }
     set_sd_state(SDState::Idle);
     SD_ready_next          = false;
+    SD_restart_line        = 0;
     sd_current_line_number = 0;
+    sd_compiled            = false;
+    sd_index_flush();
+    sd_index_fs      = NULL;
+    sd_queue_running = false;
+    gc_close_subroutine(SD_client);  // Forget a definition the file left open
+    sd_gzip_close();
     myFile.close();
     SD.end();
     return true;
@@ -93,6 +970,7 @@ boolean closeFile() {
   strip comments per http://linuxcnc.org/docs/ja/html/gcode/overview.html#gcode:comments
   make uppercase
   return true if a line is
+  line needs room for maxlen characters and a NUL; a longer line returns false
 */
 boolean readFileLine(char* line, int maxlen) {
     if (!myFile) {
@@ -100,27 +978,169 @@ boolean readFileLine(char* line, int maxlen) {
         return false;
     }
     sd_current_line_number += 1;
-    int len = 0;
-    while (myFile.available()) {
-        if (len >= maxlen) {
+    const uint8_t* start;
+    size_t         avail;
+    size_t         len = 0;
+    while ((avail = sd_peek(&start)) > 0) {
+        const uint8_t* eol = (const uint8_t*)memchr(start, '\n', avail);
+        size_t         n   = eol ? eol - start : avail;
+        if (len + n > size_t(maxlen)) {
             return false;
         }
-        char c = myFile.read();
-        if (c == '\n') {
+        memcpy(line + len, start, n);
+        len += n;
+        sd_consume(eol ? n + 1 : n);  // Consume the newline too
+        if (eol) {
             break;
         }
-        line[len++] = c;
     }
     line[len] = '\0';
-    return len || myFile.available();
+    return !sd_failed && (len || sd_peek(&start));
+}
+
+// Reads the next line of the running job, from text or from a compiled sidecar, and
+// executes it. Returns false at the end of the file.
+boolean executeFileLine(Error* status) {
+    static gc_words_t words;  // Too large for the caller's stack
+    char              line[LINE_BUFFER_SIZE];
+    sd_index_checkpoint();
+    bool recording = gc_recording_subroutine();
+    switch (sd_next_line(line, &words)) {
+        case SDLine::End:
+            return false;
+        case SDLine::Text:
+            *status = execute_line(line, SD_client, SD_auth_level);
+            break;
+        case SDLine::Words:
+            *status = execute_block(&words, SD_client);
+            break;
+        default:
+            *status = Error::FsFailedRead;  // Stops the job rather than ending it as done
+            return true;
+    }
+    if (recording && !gc_recording_subroutine()) {
+        sd_definitions_end = sd_offset;  // A restart after here defines it again
+    }
+    return true;
+}
+
+// Writes the sidecar record for one source line.
+static bool sd_write_record(File& compiled, const char* line, size_t len, gc_words_t* words) {
+    uint8_t record[2 + MAX_GCODE_WORDS * (1 + sizeof(float))];
+    size_t  record_len = 0;
+    bool    as_words   = line[0] != '\0' && line[0] != '$' && line[0] != '[' && !strpbrk(line, "(;");
+    if (as_words) {
+        char block[LINE_BUFFER_SIZE];
+        memcpy(block, line, len + 1);
+        collapseGCode(block);
+        gc_tokenize_line(block, words);
+        as_words = !words->jog && words->error == Error::Ok;
+    }
+    if (as_words) {
+        record[record_len++] = uint8_t(SDRecord::Words);
+        record[record_len++] = words->count;
+        for (uint8_t i = 0; i < words->count; i++) {
+            record[record_len++] = words->word[i].letter;
+            memcpy(record + record_len, &words->word[i].value, sizeof(float));
+            record_len += sizeof(float);
+        }
+        return compiled.write(record, record_len) == record_len;
+    }
+    record[record_len++] = uint8_t(SDRecord::Text);
+    record[record_len++] = len;
+    return compiled.write(record, record_len) == record_len && compiled.write((const uint8_t*)line, len) == len;
+}
+
+// Runs a g-code file through the tokenizer and writes the result to a sidecar next to
+// it, which openJobFile() then prefers for as long as the source is unchanged. Lines are
+// split exactly as readFileLine() splits them, so line numbers in errors still match.
+// The source is read a block at a time, and other tasks get a turn between groups of
+// blocks, so a long file does not starve them.
+Error compileFile(fs::FS& fs, const char* path) {
+    static gc_words_t words;
+    char              line[LINE_BUFFER_SIZE];
+    uint8_t           block[512];
+    String            compiled_path = String(path) + SD_COMPILED_SUFFIX;
+    if (sd_is_gzip(path)) {
+        return Error::InvalidValue;  // Compressed files are run as they are
+    }
+    File source = fs.open(path);
+    if (!source || source.isDirectory()) {
+        return Error::FsFileNotFound;
+    }
+    File compiled = fs.open(compiled_path, FILE_WRITE);
+    markSDChanged();
+    if (!compiled) {
+        source.close();
+        return Error::FsFailedOpenFile;
+    }
+    sd_compiled_header_t header = { SD_COMPILED_MAGIC, uint32_t(source.size()), uint32_t(source.getLastWrite()), sd_hash(NULL, 0) };
+    Error                err    = Error::Ok;
+    if (compiled.write((uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        err = Error::FsFailedOpenFile;
+    }
+    size_t   len    = 0;  // Bytes of the line collected so far
+    uint32_t blocks = 0;
+    size_t   n;
+    while (err == Error::Ok && (n = source.read(block, sizeof(block))) > 0) {
+        header.source_hash = sd_hash(block, n, header.source_hash);
+        for (size_t i = 0; i < n; i++) {
+            if (block[i] != '\n') {
+                if (len >= SD_LINE_MAX) {
+                    err = Error::Overflow;  // readFileLine() would stop the job here
+                    break;
+                }
+                line[len++] = block[i];
+                continue;
+            }
+            line[len] = '\0';
+            if (!sd_write_record(compiled, line, len, &words)) {
+                err = Error::FsFailedOpenFile;
+                break;
+            }
+            len = 0;
+        }
+        if (++blocks % 8 == 0) {
+            vTaskDelay(1);  // Let other tasks run during a long compile
+        }
+    }
+    if (err == Error::Ok && len) {  // A last line without a newline
+        line[len] = '\0';
+        if (!sd_write_record(compiled, line, len, &words)) {
+            err = Error::FsFailedOpenFile;
+        }
+    }
+    source.close();
+    if (err == Error::Ok && !(compiled.seek(0) && compiled.write((uint8_t*)&header, sizeof(header)) == sizeof(header))) {
+        err = Error::FsFailedOpenFile;
+    }
+    compiled.close();
+    if (err != Error::Ok) {
+        fs.remove(compiled_path);
+    }
+    markSDChanged();
+    return err;
+}
+
+// Deletes a g-code file with the compiled sidecar and restart indexes made from it, so
+// a file later put under the same name does not find them. Returns false if the file
+// itself could not be deleted.
+boolean removeFile(fs::FS& fs, const char* path) {
+    String  name    = path;
+    boolean removed = fs.remove(path);
+    fs.remove(name + SD_COMPILED_SUFFIX);
+    fs.remove(name + SD_INDEX_SUFFIX);
+    fs.remove(name + SD_COMPILED_SUFFIX + SD_INDEX_SUFFIX);
+    markSDChanged();
+    return removed;
 }
 
 // return a percentage complete 50.5 = 50.5%
 float sd_report_perc_complete() {
-    if (!myFile) {
+    if (!myFile || sd_file_size == 0) {
         return 0.0;
     }
-    return (float)myFile.position() / (float)myFile.size() * 100.0f;
+    return (float)sd_offset / (float)sd_file_size * 100.0f;
 }
 
 uint32_t sd_get_current_line_number() {
@@ -130,6 +1150,7 @@ uint32_t sd_get_current_line_number() {
 SDState sd_state = SDState::Idle;
 
 SDState get_sd_state(bool refresh) {
+    sd_check_detect();
     if (SDCARD_DET_PIN != UNDEFINED_PIN) {
         if (digitalRead(SDCARD_DET_PIN) != SDCARD_DET_VAL) {
             sd_state = SDState::NotPresent;
@@ -156,6 +1177,12 @@ SDState get_sd_state(bool refresh) {
             sd_state = SDState::Idle;
         }
     }
+    //a missing card, or one of another size, may have been swapped for another
+    uint64_t card_size = sd_state == SDState::Idle ? SD.cardSize() : 0;
+    if (card_size == 0 || card_size != sd_card_size) {
+        markSDChanged();
+    }
+    sd_card_size = card_size;
     return sd_state;
 }
 
@@ -167,6 +1194,9 @@ SDState set_sd_state(SDState state) {
 void sd_get_current_filename(char* name) {
     if (myFile) {
         strcpy(name, myFile.name());
+        if (sd_compiled) {
+            name[strlen(name) - strlen(SD_COMPILED_SUFFIX)] = '\0';  // Report the source file
+        }
     } else {
         name[0] = 0;
     }
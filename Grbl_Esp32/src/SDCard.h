@@ -19,6 +19,7 @@
 #include <FS.h>
 #include <SD.h>
 #include <SPI.h>
+#include <functional>
 
 //#define SDCARD_DET_PIN -1
 const int SDCARD_DET_VAL = 0;  // for now, CD is close to ground
@@ -32,18 +33,75 @@ enum class SDState : uint8_t {
     BusyParsing   = 4,
 };
 
-extern bool                       SD_ready_next;  // Grbl has processed a line and is waiting for another
+// Suffix of the compiled sidecar that $SD/Compile writes next to a g-code file
+const char* const SD_COMPILED_SUFFIX = ".gcb";
+
+// Header of a compiled sidecar. A job uses the sidecar while its source still has the
+// size, modification time and hash recorded here.
+const uint32_t SD_COMPILED_MAGIC = 0x32424347;  // "GCB2"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t source_size;
+    uint32_t source_mtime;
+    uint32_t source_hash;  // FNV-1a of the whole source file
+} sd_compiled_header_t;
+
+// Size of each of the two buffers a running job is read through, a multiple of the
+// 512-byte SD sector so every read from the card is whole sectors
+const int SD_READ_BUFFER_SIZE = 4096;
+
+// Longest line a job may have, in characters, with or without a newline after it. A
+// longer line stops the job, and $SD/Compile refuses the file.
+const int SD_LINE_MAX = LINE_BUFFER_SIZE - 1;
+
+// Files with this suffix are gzip-compressed g-code, inflated as the job runs
+const char* const SD_GZIP_SUFFIX = ".gz";
+
+// Suffix of the restart index a running job writes next to the file it reads, and the
+// number of lines between its checkpoints
+const char* const SD_INDEX_SUFFIX   = ".gci";
+const int         SD_INDEX_INTERVAL = 1000;
+
+// Number of files $Queue/Add can line up to run one after another
+const int SD_QUEUE_SIZE = 16;
+
+// Bytes set aside to remember the last directory listed, so paging through it reads
+// the card only once. Larger directories are read again for every page. Without PSRAM
+// the bytes are given back when the last page has been listed.
+const int SD_LIST_CACHE_SIZE = 16384;
+
+// Called by listDirPage() for each entry on the page; size is 0 for a directory
+typedef std::function<void(const char* name, bool directory, uint32_t size)> sd_list_cb_t;
+
+extern bool                       SD_ready_next;    // Grbl has processed a line and is waiting for another
+extern uint32_t                   SD_restart_line;  // Line [ESP220] asked the open job to restart at, or 0
 extern uint8_t                    SD_client;
 extern WebUI::AuthenticationLevel SD_auth_level;
 
 //bool sd_mount();
-SDState  get_sd_state(bool refresh);
-SDState  set_sd_state(SDState state);
-void     listDir(fs::FS& fs, const char* dirname, uint8_t levels, uint8_t client);
-boolean  openFile(fs::FS& fs, const char* path);
-boolean  closeFile();
-boolean  readFileLine(char* line, int len);
-void     readFile(fs::FS& fs, const char* path);
-float    sd_report_perc_complete();
-uint32_t sd_get_current_line_number();
-void     sd_get_current_filename(char* name);
+SDState     get_sd_state(bool refresh);
+SDState     set_sd_state(SDState state);
+void        listDir(fs::FS& fs, const char* dirname, uint8_t levels, uint8_t client);
+uint32_t    listDirPage(const char* path, const char* filter, uint32_t offset, uint32_t limit, sd_list_cb_t each);
+bool        isDirCached(const char* path);
+void        markSDChanged();
+boolean     openFile(fs::FS& fs, const char* path);
+boolean     closeFile();
+boolean     readFileLine(char* line, int len);
+boolean     openJobFile(fs::FS& fs, const char* path);
+boolean     executeFileLine(Error* status);
+boolean     seekFileLine(uint32_t line);
+boolean     restartFile();
+Error       queueAddFile(fs::FS& fs, const char* path);
+void        queueClear();
+uint8_t     queueCount();
+const char* queueFile(uint8_t index);
+boolean     queueRun(fs::FS& fs, bool gate);
+boolean     openNextQueuedFile();
+Error       compileFile(fs::FS& fs, const char* path);
+boolean     removeFile(fs::FS& fs, const char* path);
+void        readFile(fs::FS& fs, const char* path);
+float       sd_report_perc_complete();
+uint32_t    sd_get_current_line_number();
+void        sd_get_current_filename(char* name);
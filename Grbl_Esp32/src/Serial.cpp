@@ -158,9 +158,9 @@ static uint8_t getClientChar(uint8_t* data) {
     }
 #endif
 #if defined(ENABLE_WIFI) && defined(ENABLE_TELNET)
-    if (WebUI::telnet_server.available()) {
-        *data = WebUI::telnet_server.read();
-        return CLIENT_TELNET;
+    uint8_t client = WebUI::telnet_server.read(data);
+    if (client != CLIENT_ALL) {
+        return client;
     }
 #endif
     return CLIENT_ALL;
@@ -195,15 +195,13 @@ void clientCheckTask(void* pvParameters) {
 #endif  //ENABLE_SD_CARD
             }
         }  // if something available
+        report_realtime_status_push();
         WebUI::COMMANDS::handle();
 #ifdef ENABLE_WIFI
         WebUI::wifi_config.handle();
 #endif
 #ifdef ENABLE_BLUETOOTH
         WebUI::bt_config.handle();
-#endif
-#if defined(ENABLE_WIFI) && defined(ENABLE_HTTP) && defined(ENABLE_SERIAL2SOCKET_IN)
-        WebUI::Serial2Socket.handle_flush();
 #endif
         vTaskDelay(1 / portTICK_RATE_MS);  // Yield to other tasks
 
@@ -214,10 +212,14 @@ void clientCheckTask(void* pvParameters) {
     }
 }
 
+// Drops what a client sent that was not executed yet, including a partly received line.
 void client_reset_read_buffer(uint8_t client) {
     for (uint8_t client_num = 0; client_num < CLIENT_COUNT; client_num++) {
         if (client == client_num || client == CLIENT_ALL) {
+            vTaskEnterCritical(&myMutex);
             client_buffer[client_num].begin();
+            vTaskExitCritical(&myMutex);
+            protocol_discard_line(client_num);
         }
     }
 }
@@ -347,30 +349,34 @@ void execute_realtime_command(Cmd command, uint8_t client) {
 }
 
 void client_write(uint8_t client, const char* text) {
+    client_write(client, text, strlen(text));
+}
+
+void client_write(uint8_t client, const char* text, size_t len) {
     if (client == CLIENT_INPUT) {
         return;
     }
 #ifdef ENABLE_BLUETOOTH
     if (WebUI::SerialBT.hasClient() && (client == CLIENT_BT || client == CLIENT_ALL)) {
-        WebUI::SerialBT.print(text);
+        WebUI::SerialBT.write((const uint8_t*)text, len);
         //delay(10); // possible fix for dropped characters
     }
 #endif
 #if defined(ENABLE_WIFI) && defined(ENABLE_HTTP) && defined(ENABLE_SERIAL2SOCKET_OUT)
     if (client == CLIENT_WEBUI || client == CLIENT_ALL) {
-        WebUI::Serial2Socket.write((const uint8_t*)text, strlen(text));
+        WebUI::Serial2Socket.write((const uint8_t*)text, len);
     }
 #endif
 #if defined(ENABLE_WIFI) && defined(ENABLE_TELNET)
-    if (client == CLIENT_TELNET || client == CLIENT_ALL) {
-        WebUI::telnet_server.write((const uint8_t*)text, strlen(text));
+    if (WebUI::Telnet_Server::is_client(client) || client == CLIENT_ALL) {
+        WebUI::telnet_server.write(client, (const uint8_t*)text, len);
     }
 #endif
     if (client == CLIENT_SERIAL || client == CLIENT_ALL) {
 #ifdef REVERT_TO_ARDUINO_SERIAL
-        Serial.write(text);
+        Serial.write((const uint8_t*)text, len);
 #else
-        Uart0.write(text);
+        Uart0.write((const uint8_t*)text, len);
 #endif
     }
 }
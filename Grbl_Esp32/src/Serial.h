@@ -37,6 +37,7 @@
 void clientCheckTask(void* pvParameters);
 
 void client_write(uint8_t client, const char* text);
+void client_write(uint8_t client, const char* text, size_t len);
 
 // Fetches the first byte in the serial read buffer. Called by main program.
 int client_read(uint8_t client);
@@ -26,9 +26,10 @@
 
 namespace WebUI {
 #if defined(ENABLE_HTTP) && defined(ENABLE_WIFI)
-    ESPResponseStream::ESPResponseStream(WebServer* webserver) {
+    ESPResponseStream::ESPResponseStream(WebServer* webserver, const char* contentType) {
         _header_sent = false;
         _webserver   = webserver;
+        _contentType = contentType;
         _client      = CLIENT_WEBUI;
     }
 #endif
@@ -52,7 +53,7 @@ namespace WebUI {
 
     void ESPResponseStream::println(const char* data) {
         print(data);
-        if (_client == CLIENT_TELNET) {
+        if (_client == CLIENT_TELNET || _client == CLIENT_TELNET2) {
             print("\r\n");
         } else {
             print("\n");
@@ -80,7 +81,7 @@ namespace WebUI {
         if (_webserver) {
             if (!_header_sent) {
                 _webserver->setContentLength(CONTENT_LENGTH_UNKNOWN);
-                _webserver->sendHeader("Content-Type", "text/html");
+                _webserver->sendHeader("Content-Type", _contentType);
                 _webserver->sendHeader("Cache-Control", "no-cache");
                 _webserver->send(200);
                 _header_sent = true;
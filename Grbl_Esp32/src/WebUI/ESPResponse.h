@@ -28,7 +28,7 @@ namespace WebUI {
     class ESPResponseStream {
     public:
 #if defined(ENABLE_HTTP) && defined(ENABLE_WIFI)
-        ESPResponseStream(WebServer* webserver);
+        ESPResponseStream(WebServer* webserver, const char* contentType = "text/html");
 #endif
         ESPResponseStream(uint8_t client, bool byid = true);
         ESPResponseStream();
@@ -45,8 +45,9 @@ namespace WebUI {
         bool    _header_sent;
 
 #if defined(ENABLE_HTTP) && defined(ENABLE_WIFI)
-        WebServer* _webserver;
-        String     _buffer;
+        WebServer*  _webserver;
+        const char* _contentType;
+        String      _buffer;
 #endif
     };
 }
@@ -3,6 +3,7 @@
 #include "../Grbl.h"
 
 #include "JSONEncoder.h"
+#include "ESPResponse.h"
 
 namespace WebUI {
     // Constructor that supplies a default falue for "pretty"
@@ -10,7 +11,46 @@ namespace WebUI {
 
     // Constructor.  If _pretty is true, newlines are
     // inserted into the JSON string for easy reading.
-    JSONencoder::JSONencoder(bool pretty) : pretty(pretty), level(0), str("") { count[level] = 0; }
+    JSONencoder::JSONencoder(bool pretty) : JSONencoder(pretty, NULL) {}
+
+    // Constructor.  If stream is not NULL, the JSON text
+    // is sent to it through a small fixed buffer.
+    JSONencoder::JSONencoder(bool pretty, ESPResponseStream* stream) : pretty(pretty), level(0), str(""), stream(stream), buffered(0) {
+        count[level] = 0;
+    }
+
+    // Private function to add a character to the string
+    // or to the buffer for the stream.
+    void JSONencoder::add(char c) {
+        if (stream) {
+            buffer[buffered++] = c;
+            if (buffered == BUFFER_SIZE - 1) {
+                flush_buffer();
+            }
+        } else {
+            str += c;
+        }
+    }
+
+    // Private function to add a C-style string.
+    void JSONencoder::add(const char* s) {
+        if (stream) {
+            while (*s) {
+                add(*s++);
+            }
+        } else {
+            str.concat(s);
+        }
+    }
+
+    // Private function to send the buffer to the stream.
+    void JSONencoder::flush_buffer() {
+        if (buffered) {
+            buffer[buffered] = '\0';
+            stream->print(buffer);
+            buffered = 0;
+        }
+    }
 
     // Private function to add commas between
     // elements as needed, omitting the comma
@@ -38,7 +78,7 @@ namespace WebUI {
     // Private function to add a name enclosed with quotes.
     void JSONencoder::quoted(const char* s) {
         add('"');
-        str.concat(s);
+        add(s);
         add('"');
     }
 
@@ -73,6 +113,9 @@ namespace WebUI {
     // and returning the encoded string
     String JSONencoder::end() {
         end_object();
+        if (stream) {
+            flush_buffer();
+        }
         return str;
     }
 
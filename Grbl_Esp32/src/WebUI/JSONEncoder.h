@@ -3,21 +3,29 @@
 // Class for creating JSON-encoded strings.
 
 namespace WebUI {
+    class ESPResponseStream;
+
     class JSONencoder {
     private:
         static const int MAX_JSON_LEVEL = 16;
+        static const int BUFFER_SIZE    = 256;
 
-        bool   pretty;
-        int    level;
-        String str;
-        int    count[MAX_JSON_LEVEL];
-        void   add(char c) { str += c; }
-        void   comma_line();
-        void   comma();
-        void   quoted(const char* s);
-        void   inc_level();
-        void   dec_level();
-        void   line();
+        bool               pretty;
+        int                level;
+        String             str;
+        ESPResponseStream* stream;
+        char               buffer[BUFFER_SIZE];
+        int                buffered;
+        int                count[MAX_JSON_LEVEL];
+        void               add(char c);
+        void               add(const char* s);
+        void               flush_buffer();
+        void               comma_line();
+        void               comma();
+        void               quoted(const char* s);
+        void               inc_level();
+        void               dec_level();
+        void               line();
 
     public:
         // If you don't set _pretty it defaults to false
@@ -26,10 +34,16 @@ namespace WebUI {
         // Constructor; set _pretty true for pretty printing
         JSONencoder(bool pretty);
 
+        // Constructor for streaming; the encoded text is sent to stream
+        // in small pieces as it is generated instead of being collected
+        // into a String, so long lists need no large allocation.
+        JSONencoder(bool pretty, ESPResponseStream* stream);
+
         // begin() starts the encoding process.
         void begin();
 
-        // end() returns the encoded string
+        // end() returns the encoded string, or an empty one when
+        // streaming, after sending whatever is still buffered
         String end();
 
         // member() creates a "tag":"value" element
@@ -46,17 +46,24 @@ namespace WebUI {
 
     static const int EMAILTIMEOUT = 5000;
 
+    // Messages queued for the sender task, and how it retries one that fails
+    static const int NOTIFICATION_QUEUE_SIZE = 8;
+    static const int NOTIFICATION_ATTEMPTS   = 4;
+    static const int NOTIFICATION_BACKOFF    = 2000;  // ms before the first retry, doubled for each one after
+
     NotificationsService notificationsservice;
 
     NotificationsService::NotificationsService() {
-        _started          = false;
-        _notificationType = 0;
-        _token1           = "";
-        _token1           = "";
-        _settings         = "";
+        _queue       = NULL;
+        _task        = NULL;
+        _lock        = NULL;
+        _client      = NULL;
+        _started     = false;
+        _config.type = 0;
+        _config.port = 0;
     }
 
-    bool Wait4Answer(WiFiClientSecure& client, const char* linetrigger, const char* expected_answer, uint32_t timeout) {
+    bool Wait4Answer(Client& client, const char* linetrigger, const char* expected_answer, uint32_t timeout) {
         if (client.connected()) {
             String   answer;
             uint32_t starttimeout = millis();
@@ -87,7 +94,7 @@ namespace WebUI {
     bool NotificationsService::started() { return _started; }
 
     const char* NotificationsService::getTypeString() {
-        switch (_notificationType) {
+        switch (_config.type) {
             case ESP_PUSHOVER_NOTIFICATION:
                 return "Pushover";
             case ESP_EMAIL_NOTIFICATION:
@@ -99,44 +106,95 @@ namespace WebUI {
         }
     }
 
+    // Sends with a copy of the settings taken under _lock, so that begin() or end()
+    // running meanwhile in another task cannot change them in the middle of a send.
     bool NotificationsService::sendMSG(const char* title, const char* message) {
-        if (!_started) {
+        if (_lock == NULL || ((strlen(title) == 0) && (strlen(message) == 0))) {
             return false;
         }
-        if (!((strlen(title) == 0) && (strlen(message) == 0))) {
-            switch (_notificationType) {
-                case ESP_PUSHOVER_NOTIFICATION:
-                    return sendPushoverMSG(title, message);
-                    break;
-                case ESP_EMAIL_NOTIFICATION:
-                    return sendEmailMSG(title, message);
-                    break;
-                case ESP_LINE_NOTIFICATION:
-                    return sendLineMSG(title, message);
+        notification_config_t config;
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        bool started = _started;
+        config       = _config;
+        xSemaphoreGive(_lock);
+        if (!started) {
+            return false;
+        }
+        WiFiClientSecure secure;
+        Client&          client = _client ? *_client : secure;
+        switch (config.type) {
+            case ESP_PUSHOVER_NOTIFICATION:
+                return sendPushoverMSG(config, client, title, message);
+            case ESP_EMAIL_NOTIFICATION:
+                return sendEmailMSG(config, client, title, message);
+            case ESP_LINE_NOTIFICATION:
+                return sendLineMSG(config, client, title, message);
+            default:
+                return false;
+        }
+    }
+
+    // Hands a message to notificationTask and returns at once, so that a slow
+    // or unreachable server never holds up the caller. Returns false if the
+    // service is not running or the queue is full, in which case it is dropped.
+    bool NotificationsService::queueMSG(const char* title, const char* message) {
+        if (!_started || _queue == NULL || ((strlen(title) == 0) && (strlen(message) == 0))) {
+            return false;
+        }
+        notification_t notification;
+        strlcpy(notification.title, title, sizeof(notification.title));
+        strlcpy(notification.message, message, sizeof(notification.message));
+        if (xQueueSend(_queue, &notification, 0) != pdTRUE) {
+            log_w("Notification queue full, dropped: %s", title);
+            return false;
+        }
+        return true;
+    }
+
+    // Sends queued messages one at a time, retrying each with a growing delay
+    void NotificationsService::notificationTask(void* pvParameters) {
+        NotificationsService* service = (NotificationsService*)pvParameters;
+        notification_t        notification;
+        while (true) {
+            xQueueReceive(service->_queue, &notification, portMAX_DELAY);
+            uint32_t backoff = NOTIFICATION_BACKOFF;
+            for (int attempt = 1; attempt <= NOTIFICATION_ATTEMPTS; attempt++) {
+                if (service->sendMSG(notification.title, notification.message)) {
                     break;
-                default:
+                }
+                if (!service->_started || attempt == NOTIFICATION_ATTEMPTS) {
+                    log_w("Notification not sent: %s", notification.title);
                     break;
+                }
+                vTaskDelay(backoff / portTICK_PERIOD_MS);
+                backoff *= 2;
             }
+
+            static UBaseType_t uxHighWaterMark = 0;
+#    ifdef DEBUG_TASK_STACK
+            reportTaskStackSize(uxHighWaterMark);
+#    endif
         }
-        return false;
     }
 
     //Messages are currently limited to 1024 4-byte UTF-8 characters
     //but we do not do any check
-    bool NotificationsService::sendPushoverMSG(const char* title, const char* message) {
-        String           data;
-        String           postcmd;
-        bool             res;
-        WiFiClientSecure Notificationclient;
-        if (!Notificationclient.connect(_serveraddress.c_str(), _port)) {
-            log_d("Error connecting  server %s:%d", _serveraddress.c_str(), _port);
+    bool NotificationsService::sendPushoverMSG(const notification_config_t& config,
+                                               Client&                      Notificationclient,
+                                               const char*                  title,
+                                               const char*                  message) {
+        String data;
+        String postcmd;
+        bool   res;
+        if (!Notificationclient.connect(config.serveraddress.c_str(), config.port)) {
+            log_d("Error connecting  server %s:%d", config.serveraddress.c_str(), config.port);
             return false;
         }
         //build data for post
         data = "user=";
-        data += _token1;
+        data += config.token1;
         data += "&token=";
-        data += _token2;
+        data += config.token2;
         ;
         data += "&title=";
         data += title;
@@ -157,11 +215,13 @@ namespace WebUI {
         Notificationclient.stop();
         return res;
     }
-    bool NotificationsService::sendEmailMSG(const char* title, const char* message) {
-        WiFiClientSecure Notificationclient;
+    bool NotificationsService::sendEmailMSG(const notification_config_t& config,
+                                            Client&                      Notificationclient,
+                                            const char*                  title,
+                                            const char*                  message) {
         log_d("Connect to server");
-        if (!Notificationclient.connect(_serveraddress.c_str(), _port)) {
-            log_d("Error connecting  server %s:%d", _serveraddress.c_str(), _port);
+        if (!Notificationclient.connect(config.serveraddress.c_str(), config.port)) {
+            log_d("Error connecting  server %s:%d", config.serveraddress.c_str(), config.port);
             return false;
         }
         //Check answer of connection
@@ -185,28 +245,28 @@ namespace WebUI {
         }
         log_d("Send LOGIN");
         //sent Login
-        Notificationclient.printf("%s\r\n", _token1.c_str());
+        Notificationclient.printf("%s\r\n", config.token1.c_str());
         if (!Wait4Answer(Notificationclient, "334", "334", EMAILTIMEOUT)) {
             log_d("Sent login failed!");
             return false;
         }
         log_d("Send PASSWORD");
         //Send password
-        Notificationclient.printf("%s\r\n", _token2.c_str());
+        Notificationclient.printf("%s\r\n", config.token2.c_str());
         if (!Wait4Answer(Notificationclient, "235", "235", EMAILTIMEOUT)) {
             log_d("Sent password failed!");
             return false;
         }
         log_d("MAIL FROM");
         //Send From
-        Notificationclient.printf("MAIL FROM: <%s>\r\n", _settings.c_str());
+        Notificationclient.printf("MAIL FROM: <%s>\r\n", config.settings.c_str());
         if (!Wait4Answer(Notificationclient, "250", "250", EMAILTIMEOUT)) {
             log_d("MAIL FROM failed!");
             return false;
         }
         log_d("RCPT TO");
         //Send To
-        Notificationclient.printf("RCPT TO: <%s>\r\n", _settings.c_str());
+        Notificationclient.printf("RCPT TO: <%s>\r\n", config.settings.c_str());
         if (!Wait4Answer(Notificationclient, "250", "250", EMAILTIMEOUT)) {
             log_d("RCPT TO failed!");
             return false;
@@ -220,8 +280,8 @@ namespace WebUI {
         }
         log_d("Send message");
         //Send message
-        Notificationclient.printf("From:ESP3D<%s>\r\n", _settings.c_str());
-        Notificationclient.printf("To: <%s>\r\n", _settings.c_str());
+        Notificationclient.printf("From:ESP3D<%s>\r\n", config.settings.c_str());
+        Notificationclient.printf("To: <%s>\r\n", config.settings.c_str());
         Notificationclient.printf("Subject: %s\r\n\r\n", title);
         Notificationclient.println(message);
         log_d("Send final dot");
@@ -241,14 +301,16 @@ namespace WebUI {
         Notificationclient.stop();
         return true;
     }
-    bool NotificationsService::sendLineMSG(const char* title, const char* message) {
-        String           data;
-        String           postcmd;
-        bool             res;
-        WiFiClientSecure Notificationclient;
+    bool NotificationsService::sendLineMSG(const notification_config_t& config,
+                                           Client&                      Notificationclient,
+                                           const char*                  title,
+                                           const char*                  message) {
+        String data;
+        String postcmd;
+        bool   res;
         (void)title;
-        if (!Notificationclient.connect(_serveraddress.c_str(), _port)) {
-            log_d("Error connecting  server %s:%d", _serveraddress.c_str(), _port);
+        if (!Notificationclient.connect(config.serveraddress.c_str(), config.port)) {
+            log_d("Error connecting  server %s:%d", config.serveraddress.c_str(), config.port);
             return false;
         }
         //build data for post
@@ -259,7 +321,7 @@ namespace WebUI {
                   "ESP3D\r\nAccept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\nContent-Type: "
                   "application/x-www-form-urlencoded\r\n";
         postcmd += "Authorization: Bearer ";
-        postcmd += _token1 + "\r\n";
+        postcmd += config.token1 + "\r\n";
         postcmd += "Content-Length: ";
         postcmd += data.length();
         postcmd += "\r\n\r\n";
@@ -272,19 +334,19 @@ namespace WebUI {
         return res;
     }
     //Email#serveraddress:port
-    bool NotificationsService::getPortFromSettings() {
+    bool NotificationsService::getPortFromSettings(notification_config_t& config) {
         String tmp = notification_ts->get();
         int    pos = tmp.lastIndexOf(':');
         if (pos == -1) {
             return false;
         }
 
-        _port = tmp.substring(pos + 1).toInt();
-        log_d("port : %d", _port);
-        return _port > 0;
+        config.port = tmp.substring(pos + 1).toInt();
+        log_d("port : %d", config.port);
+        return config.port > 0;
     }
     //Email#serveraddress:port
-    bool NotificationsService::getServerAddressFromSettings() {
+    bool NotificationsService::getServerAddressFromSettings(notification_config_t& config) {
         String tmp  = notification_ts->get();
         int    pos1 = tmp.indexOf('#');
         int    pos2 = tmp.lastIndexOf(':');
@@ -293,44 +355,49 @@ namespace WebUI {
         }
 
         //TODO add a check for valid email ?
-        _serveraddress = tmp.substring(pos1 + 1, pos2);
-        log_d("server : %s", _serveraddress.c_str());
+        config.serveraddress = tmp.substring(pos1 + 1, pos2);
+        log_d("server : %s", config.serveraddress.c_str());
         return true;
     }
     //Email#serveraddress:port
-    bool NotificationsService::getEmailFromSettings() {
+    bool NotificationsService::getEmailFromSettings(notification_config_t& config) {
         String tmp = notification_ts->get();
         int    pos = tmp.indexOf('#');
         if (pos == -1) {
             return false;
         }
-        _settings = tmp.substring(0, pos);
-        log_d("email : %s", _settings.c_str());
+        config.settings = tmp.substring(0, pos);
+        log_d("email : %s", config.settings.c_str());
         //TODO add a check for valid email ?
         return true;
     }
 
     bool NotificationsService::begin() {
+        if (_lock == NULL) {
+            _lock = xSemaphoreCreateMutex();
+        }
         end();
-        _notificationType = notification_type->get();
-        switch (_notificationType) {
+        notification_config_t config;
+        config.type = notification_type->get();
+        config.port = 0;
+        switch (config.type) {
             case 0:  //no notification = no error but no start
                 return true;
             case ESP_PUSHOVER_NOTIFICATION:
-                _token1        = notification_t1->get();
-                _token2        = notification_t2->get();
-                _port          = PUSHOVERPORT;
-                _serveraddress = PUSHOVERSERVER;
+                config.token1        = notification_t1->get();
+                config.token2        = notification_t2->get();
+                config.port          = PUSHOVERPORT;
+                config.serveraddress = PUSHOVERSERVER;
                 break;
             case ESP_LINE_NOTIFICATION:
-                _token1        = notification_t1->get();
-                _port          = LINEPORT;
-                _serveraddress = LINESERVER;
+                config.token1        = notification_t1->get();
+                config.port          = LINEPORT;
+                config.serveraddress = LINESERVER;
                 break;
             case ESP_EMAIL_NOTIFICATION:
-                _token1 = base64::encode(notification_t1->get());
-                _token2 = base64::encode(notification_t2->get());
-                if (!getEmailFromSettings() || !getPortFromSettings() || !getServerAddressFromSettings()) {
+                config.token1 = base64::encode(notification_t1->get());
+                config.token2 = base64::encode(notification_t2->get());
+                if (!getEmailFromSettings(config) || !getPortFromSettings(config) || !getServerAddressFromSettings(config)) {
                     return false;
                 }
                 break;
@@ -338,15 +405,26 @@ namespace WebUI {
                 return false;
                 break;
         }
-        bool res = true;
         if (WiFi.getMode() != WIFI_STA) {
-            res = false;
+            return false;
         }
-        if (!res) {
-            end();
+        if (_task == NULL) {
+            _queue = xQueueCreate(NOTIFICATION_QUEUE_SIZE, sizeof(notification_t));
+            // TLS handshakes need a large stack
+            xTaskCreatePinnedToCore(notificationTask,    // task
+                                    "notificationTask",  // name for task
+                                    8192,                // size of task stack
+                                    this,                // parameters
+                                    1,                   // priority
+                                    &_task,
+                                    SUPPORT_TASK_CORE  // core
+            );
         }
-        _started = res;
-        return _started;
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        _config  = config;
+        _started = true;
+        xSemaphoreGive(_lock);
+        return true;
     }
 
     void NotificationsService::end() {
@@ -354,13 +432,10 @@ namespace WebUI {
             return;
         }
 
-        _started          = false;
-        _notificationType = 0;
-        _token1           = "";
-        _token1           = "";
-        _settings         = "";
-        _serveraddress    = "";
-        _port             = 0;
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        _started = false;
+        _config  = notification_config_t();
+        xSemaphoreGive(_lock);
     }
 
     void NotificationsService::handle() {
@@ -20,6 +20,8 @@
   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
+class Client;
+
 namespace WebUI {
     class NotificationsService {
     public:
@@ -29,26 +31,50 @@ namespace WebUI {
         void        end();
         void        handle();
         bool        sendMSG(const char* title, const char* message);
+        bool        queueMSG(const char* title, const char* message);
         const char* getTypeString();
         bool        started();
 
+        // Sends over client instead of a new TLS connection, or over TLS again when
+        // client is NULL. For talking to a stand-in server in tests.
+        void setClient(Client* client) { _client = client; }
+
         ~NotificationsService();
 
     private:
-        bool     _started;
-        uint8_t  _notificationType;
-        String   _token1;
-        String   _token2;
-        String   _settings;
-        String   _serveraddress;
-        uint16_t _port;
-
-        bool sendPushoverMSG(const char* title, const char* message);
-        bool sendEmailMSG(const char* title, const char* message);
-        bool sendLineMSG(const char* title, const char* message);
-        bool getPortFromSettings();
-        bool getServerAddressFromSettings();
-        bool getEmailFromSettings();
+        // A message waiting for notificationTask, cut short if it does not fit
+        typedef struct {
+            char title[48];
+            char message[208];
+        } notification_t;
+
+        // Where and how to send. begin() and end() change it under _lock, and every
+        // send works from a copy, so the settings never change under a send.
+        typedef struct {
+            uint8_t  type;
+            String   token1;
+            String   token2;
+            String   settings;
+            String   serveraddress;
+            uint16_t port;
+        } notification_config_t;
+
+        static void notificationTask(void* pvParameters);
+
+        QueueHandle_t     _queue;
+        TaskHandle_t      _task;
+        SemaphoreHandle_t _lock;
+        Client*           _client;
+
+        bool                  _started;
+        notification_config_t _config;
+
+        bool sendPushoverMSG(const notification_config_t& config, Client& client, const char* title, const char* message);
+        bool sendEmailMSG(const notification_config_t& config, Client& client, const char* title, const char* message);
+        bool sendLineMSG(const notification_config_t& config, Client& client, const char* title, const char* message);
+        bool getPortFromSettings(notification_config_t& config);
+        bool getServerAddressFromSettings(notification_config_t& config);
+        bool getEmailFromSettings(notification_config_t& config);
     };
 
     extern NotificationsService notificationsservice;
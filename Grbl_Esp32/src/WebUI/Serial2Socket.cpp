@@ -32,9 +32,15 @@ namespace WebUI {
 
     Serial_2_Socket::Serial_2_Socket() {
         _web_socket   = NULL;
+        _sender       = NULL;
+        _TXmutex      = xSemaphoreCreateMutex();
+        _lastflush    = 0;
+        _lineEnd      = false;
+        _TXfill       = 0;
         _TXbufferSize = 0;
         _RXbufferSize = 0;
         _RXbufferpos  = 0;
+        vPortCPUInitializeMutex(&_RXmux);
     }
 
     void Serial_2_Socket::begin(long speed) {
@@ -51,8 +57,10 @@ namespace WebUI {
 
     long Serial_2_Socket::baudRate() { return 0; }
 
-    bool Serial_2_Socket::attachWS(WebSocketsServer* web_socket) {
+    // sender is the task that runs web_socket; all sends are made from it
+    bool Serial_2_Socket::attachWS(WebSocketsServer* web_socket, TaskHandle_t sender) {
         if (web_socket) {
+            _sender       = sender;
             _web_socket   = web_socket;
             _TXbufferSize = 0;
             return true;
@@ -89,22 +97,41 @@ namespace WebUI {
         }
 
 #    if defined(ENABLE_SERIAL2SOCKET_OUT)
-        if (_TXbufferSize == 0) {
-            _lastflush = millis();
+        // Writers only buffer. The web server task sends, so a slow browser holds up that
+        // task alone, and broadcasts never run alongside _web_socket->loop().
+        xSemaphoreTake(_TXmutex, portMAX_DELAY);
+        for (size_t done = 0; done < size;) {
+            if (_TXbufferSize == TXBUFFERSIZE) {
+                xSemaphoreGive(_TXmutex);
+                if (is_sender()) {
+                    send_buffer(true);
+                } else if (!wait_for_room()) {
+                    log_i("[SOCKET]output dropped");
+                    return size;
+                }
+                xSemaphoreTake(_TXmutex, portMAX_DELAY);
+                continue;
+            }
+            if (_TXbufferSize == 0) {
+                _firstwrite = millis();
+            }
+            size_t chunk = min(size - done, size_t(TXBUFFERSIZE - _TXbufferSize));
+            memcpy(_TXbuffer[_TXfill] + TXHEADROOM + _TXbufferSize, buffer + done, chunk);
+            _TXbufferSize += chunk;
+            done += chunk;
         }
-
-        //send full line
-        if (_TXbufferSize + size > TXBUFFERSIZE) {
-            flush();
+        log_i("[SOCKET]buffer size %d", _TXbufferSize);
+        // A complete line, such as ok or a status report, wakes the web server task to send
+        // it. If lines arrive faster than one per COALESCETIME, that task sends them together
+        // when the time is up, so a burst of lines costs one frame.
+        bool lineEnd = memchr(buffer, '\n', size) != NULL;
+        if (lineEnd) {
+            _lineEnd = true;
         }
-
-        //need periodic check to force to flush in case of no end
-        for (int i = 0; i < size; i++) {
-            _TXbuffer[_TXbufferSize] = buffer[i];
-            _TXbufferSize++;
+        xSemaphoreGive(_TXmutex);
+        if (lineEnd && _sender) {
+            xTaskNotifyGive(_sender);
         }
-        log_i("[SOCKET]buffer size %d", _TXbufferSize);
-        handle_flush();
 #    endif
         return size;
     }
@@ -120,6 +147,7 @@ namespace WebUI {
     bool Serial_2_Socket::push(const char* data) {
 #    if defined(ENABLE_SERIAL2SOCKET_IN)
         int data_size = strlen(data);
+        portENTER_CRITICAL(&_RXmux);
         if ((data_size + _RXbufferSize) <= RXBUFFERSIZE) {
             int current = _RXbufferpos + _RXbufferSize;
             if (current > RXBUFFERSIZE) {
@@ -134,9 +162,11 @@ namespace WebUI {
                 current++;
             }
 
-            _RXbufferSize += strlen(data);
+            _RXbufferSize += data_size;
+            portEXIT_CRITICAL(&_RXmux);
             return true;
         }
+        portEXIT_CRITICAL(&_RXmux);
         return false;
 #    else
         return true;
@@ -144,36 +174,83 @@ namespace WebUI {
     }
 
     int Serial_2_Socket::read(void) {
+        int v = -1;
+        portENTER_CRITICAL(&_RXmux);
         if (_RXbufferSize > 0) {
-            int v = _RXbuffer[_RXbufferpos];
+            v = _RXbuffer[_RXbufferpos];
             _RXbufferpos++;
 
             if (_RXbufferpos > (RXBUFFERSIZE - 1)) {
                 _RXbufferpos = 0;
             }
             _RXbufferSize--;
-            return v;
-        } else {
-            return -1;
         }
+        portEXIT_CRITICAL(&_RXmux);
+        return v;
     }
 
-    void Serial_2_Socket::handle_flush() {
-        if (_TXbufferSize > 0 && ((_TXbufferSize >= TXBUFFERSIZE) || ((millis() - _lastflush) > FLUSHTIMEOUT))) {
-            log_i("[SOCKET]need flush, buffer size %d", _TXbufferSize);
-            flush();
+    // Called from the web server task
+    void Serial_2_Socket::handle_flush() { send_buffer(false); }
+
+    // Hands buffered output to the web server task, which sends it on its next pass.
+    void Serial_2_Socket::flush(void) {
+        if (is_sender()) {
+            send_buffer(true);
+            return;
+        }
+        xSemaphoreTake(_TXmutex, portMAX_DELAY);
+        _lineEnd = _TXbufferSize > 0;
+        xSemaphoreGive(_TXmutex);
+        if (_sender) {
+            xTaskNotifyGive(_sender);
         }
     }
-    void Serial_2_Socket::flush(void) {
-        if (_TXbufferSize > 0) {
-            log_i("[SOCKET]flush data, buffer size %d", _TXbufferSize);
-            _web_socket->broadcastBIN(_TXbuffer, _TXbufferSize);
 
-            //refresh timout
-            _lastflush = millis();
+    bool Serial_2_Socket::is_sender() { return _sender != NULL && xTaskGetCurrentTaskHandle() == _sender; }
 
-            //reset buffer
-            _TXbufferSize = 0;
+    // Wakes the web server task to send a full buffer and waits for it to take it.
+    // Gives up after FLUSHTIMEOUT, when the browser is not taking data.
+    bool Serial_2_Socket::wait_for_room() {
+        if (_sender == NULL) {
+            return false;
+        }
+        xTaskNotifyGive(_sender);
+        uint32_t start = millis();
+        while (_TXbufferSize == TXBUFFERSIZE) {
+            if ((millis() - start) >= FLUSHTIMEOUT) {
+                return false;
+            }
+            vTaskDelay(1 / portTICK_RATE_MS);
+        }
+        return true;
+    }
+
+    // Swaps the buffers and sends the one that was being filled, if it is due or force
+    // is set. Only the web server task calls this, and the lock is released before the
+    // send, so writers keep filling the other buffer while a frame goes out.
+    void Serial_2_Socket::send_buffer(bool force) {
+        static_assert(TXHEADROOM == WEBSOCKETS_MAX_HEADER_SIZE, "TXHEADROOM must match arduinoWebSockets");
+        uint8_t* data = NULL;
+        size_t   len  = 0;
+        xSemaphoreTake(_TXmutex, portMAX_DELAY);
+        if (_TXbufferSize > 0) {
+            uint32_t now = millis();
+            if (force || _TXbufferSize >= TXBUFFERSIZE || (_lineEnd && (now - _lastflush) >= COALESCETIME) || (now - _firstwrite) > FLUSHTIMEOUT) {
+                log_i("[SOCKET]flush data, buffer size %d", _TXbufferSize);
+                data = _TXbuffer[_TXfill];
+                len  = _TXbufferSize;
+                //refresh timout
+                _lastflush = now;
+                //reset buffer, writers fill the other one from now on
+                _TXfill       = 1 - _TXfill;
+                _TXbufferSize = 0;
+                _lineEnd      = false;
+            }
+        }
+        xSemaphoreGive(_TXmutex);
+        if (len > 0 && _web_socket) {
+            // The library writes each frame header into the headroom, so nothing is copied or allocated
+            _web_socket->broadcastBIN(data, len, true);
         }
     }
 
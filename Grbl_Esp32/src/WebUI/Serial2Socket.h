@@ -22,14 +22,19 @@
 
 #include <Print.h>
 #include <cstring>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 
 class WebSocketsServer;
 
 namespace WebUI {
     class Serial_2_Socket : public Print {
         static const int TXBUFFERSIZE = 1200;
+        static const int TXHEADROOM   = 14;   // WEBSOCKETS_MAX_HEADER_SIZE, so frames are built in place
         static const int RXBUFFERSIZE = 256;
-        static const int FLUSHTIMEOUT = 500;
+        static const int FLUSHTIMEOUT = 500;  // Longest wait for the end of a partial line, in ms
+        static const int COALESCETIME = 5;    // Shortest time between sends of complete lines, in ms
 
     public:
         Serial_2_Socket();
@@ -52,7 +57,7 @@ namespace WebUI {
         bool push(const char* data);
         void flush(void);
         void handle_flush();
-        bool attachWS(WebSocketsServer* web_socket);
+        bool attachWS(WebSocketsServer* web_socket, TaskHandle_t sender);
         bool detachWS();
 
         operator bool() const;
@@ -60,15 +65,26 @@ namespace WebUI {
         ~Serial_2_Socket();
 
     private:
-        uint32_t          _lastflush;
+        bool is_sender();
+        bool wait_for_room();
+        void send_buffer(bool force);
+
+        uint32_t          _lastflush;   // When the buffer was last sent
+        uint32_t          _firstwrite;  // When the oldest unsent byte was written
+        bool              _lineEnd;     // The buffer holds at least one complete line
+        SemaphoreHandle_t _TXmutex;     // Guards the buffer being filled, never held while sending
+        TaskHandle_t      _sender;      // The web server task, the only one that sends
         WebSocketsServer* _web_socket;
 
-        uint8_t  _TXbuffer[TXBUFFERSIZE];
+        // Writers fill one buffer while the web server task sends the other
+        uint8_t  _TXbuffer[2][TXHEADROOM + TXBUFFERSIZE];  // Data starts after the frame header space
+        uint8_t  _TXfill;                                  // Index of the buffer being filled
         uint16_t _TXbufferSize;
 
-        uint8_t  _RXbuffer[RXBUFFERSIZE];
-        uint16_t _RXbufferSize;
-        uint16_t _RXbufferpos;
+        uint8_t      _RXbuffer[RXBUFFERSIZE];
+        uint16_t     _RXbufferSize;
+        uint16_t     _RXbufferpos;
+        portMUX_TYPE _RXmux;  // push() runs in the web server task, read() in clientCheckTask
     };
 
     extern Serial_2_Socket Serial2Socket;
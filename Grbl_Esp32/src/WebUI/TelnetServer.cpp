@@ -35,20 +35,37 @@ namespace WebUI {
     WiFiServer*   Telnet_Server::_telnetserver = NULL;
     WiFiClient    Telnet_Server::_telnetClients[MAX_TLNT_CLIENTS];
 
+    const uint8_t Telnet_Server::_clientIds[MAX_TLNT_CLIENTS] = { CLIENT_TELNET, CLIENT_TELNET2 };
+
 #    ifdef ENABLE_TELNET_WELCOME_MSG
     IPAddress Telnet_Server::_telnetClientsIP[MAX_TLNT_CLIENTS];
 #    endif
 
     Telnet_Server::Telnet_Server() {
-        _RXbufferSize = 0;
-        _RXbufferpos  = 0;
+        _nextRead = 0;
+        for (int i = 0; i < MAX_TLNT_CLIENTS; i++) {
+            clearBuffer(i);
+        }
+    }
+
+    //index of the connection that has this client id, -1 if none
+    int Telnet_Server::index_of(uint8_t client) {
+        for (int i = 0; i < MAX_TLNT_CLIENTS; i++) {
+            if (_clientIds[i] == client) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void Telnet_Server::clearBuffer(int index) {
+        _RX[index].size = 0;
+        _RX[index].pos  = 0;
     }
 
     bool Telnet_Server::begin() {
         bool no_error = true;
         end();
-        _RXbufferSize = 0;
-        _RXbufferpos  = 0;
 
         if (telnet_enable->get() == 0) {
             return false;
@@ -67,15 +84,18 @@ namespace WebUI {
     }
 
     void Telnet_Server::end() {
-        _setupdone    = false;
-        _RXbufferSize = 0;
-        _RXbufferpos  = 0;
+        _setupdone = false;
+        for (int i = 0; i < MAX_TLNT_CLIENTS; i++) {
+            clearBuffer(i);
+        }
         if (_telnetserver) {
             delete _telnetserver;
             _telnetserver = NULL;
         }
     }
 
+    //accepts new connections, only from handle() so that a slot and its
+    //buffers are never reset while the same task is pushing or reading them
     void Telnet_Server::clearClients() {
         //check if there are any new clients
         if (_telnetserver->hasClient()) {
@@ -90,6 +110,12 @@ namespace WebUI {
                         _telnetClients[i].stop();
                     }
                     _telnetClients[i] = _telnetserver->available();
+                    //send each response as soon as it is written, an ok must not wait for more data
+                    _telnetClients[i].setNoDelay(true);
+                    //a new peer does not inherit what the last one left unread,
+                    //nor the line it was typing
+                    clearBuffer(i);
+                    client_reset_read_buffer(_clientIds[i]);
                     break;
                 }
             }
@@ -100,19 +126,17 @@ namespace WebUI {
         }
     }
 
-    size_t Telnet_Server::write(const uint8_t* buffer, size_t size) {
+    //writes to the connection with this client id, or to all for CLIENT_ALL
+    size_t Telnet_Server::write(uint8_t client, const uint8_t* buffer, size_t size) {
         size_t wsize = 0;
         if (!_setupdone || _telnetserver == NULL) {
             log_d("[TELNET out blocked]");
             return 0;
         }
 
-        clearClients();
-
         //log_d("[TELNET out]");
-        //push UART data to all connected telnet clients
         for (uint8_t i = 0; i < MAX_TLNT_CLIENTS; i++) {
-            if (_telnetClients[i] && _telnetClients[i].connected()) {
+            if ((client == CLIENT_ALL || client == _clientIds[i]) && _telnetClients[i] && _telnetClients[i].connected()) {
                 //log_d("[TELNET out connected]");
                 wsize = _telnetClients[i].write(buffer, size);
                 COMMANDS::wait(0);
@@ -129,20 +153,20 @@ namespace WebUI {
         }
         clearClients();
         //check clients for data
-        //uint8_t c;
         for (uint8_t i = 0; i < MAX_TLNT_CLIENTS; i++) {
             if (_telnetClients[i] && _telnetClients[i].connected()) {
 #    ifdef ENABLE_TELNET_WELCOME_MSG
                 if (_telnetClientsIP[i] != _telnetClients[i].remoteIP()) {
-                    report_init_message(CLIENT_TELNET);
+                    report_init_message(_clientIds[i]);
                     _telnetClientsIP[i] = _telnetClients[i].remoteIP();
                 }
 #    endif
                 if (_telnetClients[i].available()) {
                     uint8_t buf[1024];
                     COMMANDS::wait(0);
+                    //take only what fits, the rest stays in the TCP window of this peer alone
                     int readlen  = _telnetClients[i].available();
-                    int writelen = TELNETRXBUFFERSIZE - available();
+                    int writelen = TELNETRXBUFFERSIZE - _RX[i].size;
                     if (readlen > 1024) {
                         readlen = 1024;
                     }
@@ -151,9 +175,8 @@ namespace WebUI {
                     }
                     if (readlen > 0) {
                         _telnetClients[i].read(buf, readlen);
-                        push(buf, readlen);
+                        push(i, buf, readlen);
                     }
-                    return;
                 }
             } else {
                 if (_telnetClients[i]) {
@@ -167,74 +190,49 @@ namespace WebUI {
         }
     }
 
-    int Telnet_Server::peek(void) {
-        if (_RXbufferSize > 0) {
-            return _RXbuffer[_RXbufferpos];
-        } else {
-            return -1;
-        }
+    int Telnet_Server::available(uint8_t client) {
+        int index = index_of(client);
+        return index < 0 ? 0 : _RX[index].size;
     }
 
-    int Telnet_Server::available() { return _RXbufferSize; }
+    int Telnet_Server::get_rx_buffer_available(uint8_t client) { return TELNETRXBUFFERSIZE - available(client); }
 
-    int Telnet_Server::get_rx_buffer_available() { return TELNETRXBUFFERSIZE - _RXbufferSize; }
-
-    bool Telnet_Server::push(uint8_t data) {
-        log_i("[TELNET]push %c", data);
-        if ((1 + _RXbufferSize) <= TELNETRXBUFFERSIZE) {
-            int current = _RXbufferpos + _RXbufferSize;
-            if (current > TELNETRXBUFFERSIZE) {
-                current = current - TELNETRXBUFFERSIZE;
-            }
-            if (current > (TELNETRXBUFFERSIZE - 1)) {
-                current = 0;
-            }
-            _RXbuffer[current] = data;
-            _RXbufferSize++;
-            log_i("[TELNET]buffer size %d", _RXbufferSize);
-            return true;
-        }
-        return false;
-    }
-
-    bool Telnet_Server::push(const uint8_t* data, int data_size) {
-        if ((data_size + _RXbufferSize) <= TELNETRXBUFFERSIZE) {
-            int data_processed = 0;
-            int current        = _RXbufferpos + _RXbufferSize;
-            if (current > TELNETRXBUFFERSIZE) {
+    bool Telnet_Server::push(int index, const uint8_t* data, int data_size) {
+        rx_buffer_t& rx = _RX[index];
+        if ((data_size + rx.size) <= TELNETRXBUFFERSIZE) {
+            int current = rx.pos + rx.size;
+            if (current >= TELNETRXBUFFERSIZE) {
                 current = current - TELNETRXBUFFERSIZE;
             }
             for (int i = 0; i < data_size; i++) {
-                if (current > (TELNETRXBUFFERSIZE - 1)) {
+                rx.data[current] = data[i];
+                if (++current == TELNETRXBUFFERSIZE) {
                     current = 0;
                 }
-
-                _RXbuffer[current] = data[i];
-                current++;
-                data_processed++;
-
-                COMMANDS::wait(0);
-                //vTaskDelay(1 / portTICK_RATE_MS);  // Yield to other tasks
             }
-            _RXbufferSize += data_processed;
+            rx.size += data_size;
             return true;
         }
         return false;
     }
 
-    int Telnet_Server::read(void) {
-        if (_RXbufferSize > 0) {
-            int v = _RXbuffer[_RXbufferpos];
-            //log_d("[TELNET]read %c",char(v));
-            _RXbufferpos++;
-            if (_RXbufferpos > (TELNETRXBUFFERSIZE - 1)) {
-                _RXbufferpos = 0;
+    //reads a byte from the next connection with data, taking turns,
+    //and returns its client id, or CLIENT_ALL if there is none
+    uint8_t Telnet_Server::read(uint8_t* data) {
+        for (int n = 0; n < MAX_TLNT_CLIENTS; n++) {
+            int          index = (_nextRead + n) % MAX_TLNT_CLIENTS;
+            rx_buffer_t& rx    = _RX[index];
+            if (rx.size > 0) {
+                *data = rx.data[rx.pos];
+                if (++rx.pos == TELNETRXBUFFERSIZE) {
+                    rx.pos = 0;
+                }
+                rx.size--;
+                _nextRead = (index + 1) % MAX_TLNT_CLIENTS;
+                return _clientIds[index];
             }
-            _RXbufferSize--;
-            return v;
-        } else {
-            return -1;
         }
+        return CLIENT_ALL;
     }
 
     Telnet_Server::~Telnet_Server() { end(); }
@@ -27,8 +27,8 @@ class WiFiClient;
 
 namespace WebUI {
     class Telnet_Server {
-        //how many clients should be able to telnet to this ESP32
-        static const int MAX_TLNT_CLIENTS = 1;
+        //how many clients should be able to telnet to this ESP32, each has its own client id
+        static const int MAX_TLNT_CLIENTS = 2;
 
         static const int TELNETRXBUFFERSIZE = 1200;
         static const int FLUSHTIMEOUT       = 500;
@@ -36,18 +36,16 @@ namespace WebUI {
     public:
         Telnet_Server();
 
-        bool   begin();
-        void   end();
-        void   handle();
-        size_t write(const uint8_t* buffer, size_t size);
-        int    read(void);
-        int    peek(void);
-        int    available();
-        int    get_rx_buffer_available();
-        bool   push(uint8_t data);
-        bool   push(const uint8_t* data, int datasize);
+        bool    begin();
+        void    end();
+        void    handle();
+        size_t  write(uint8_t client, const uint8_t* buffer, size_t size);
+        uint8_t read(uint8_t* data);
+        int     available(uint8_t client);
+        int     get_rx_buffer_available(uint8_t client);
 
         static uint16_t port() { return _port; }
+        static bool     is_client(uint8_t client) { return index_of(client) >= 0; }
 
         ~Telnet_Server();
 
@@ -60,12 +58,24 @@ namespace WebUI {
 #endif
         static uint16_t _port;
 
+        // Received data waiting to be read, one ring per connection so that
+        // each peer is throttled by its own backlog
+        struct rx_buffer_t {
+            uint8_t  data[TELNETRXBUFFERSIZE];
+            uint16_t size;
+            uint16_t pos;
+        };
+
+        static const uint8_t _clientIds[MAX_TLNT_CLIENTS];
+        static int           index_of(uint8_t client);
+
         void clearClients();
+        void clearBuffer(int index);
+        bool push(int index, const uint8_t* data, int datasize);
 
-        uint32_t _lastflush;
-        uint8_t  _RXbuffer[TELNETRXBUFFERSIZE];
-        uint16_t _RXbufferSize;
-        uint16_t _RXbufferpos;
+        uint32_t    _lastflush;
+        rx_buffer_t _RX[MAX_TLNT_CLIENTS];
+        int         _nextRead;  // Connection read() tries first, so peers take turns
     };
 
     extern Telnet_Server telnet_server;
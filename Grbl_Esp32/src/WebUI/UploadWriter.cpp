@@ -0,0 +1,137 @@
+/*
+  UploadWriter.cpp - Buffered file writer for web uploads
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../Grbl.h"
+
+#if defined(ENABLE_WIFI) && defined(ENABLE_HTTP)
+
+#    include "UploadWriter.h"
+
+namespace WebUI {
+    UploadWriter::UploadWriter() : _task(NULL), _file(NULL), _failed(false), _active(false), _direct(false), _bytes(0), _start(0) {
+        _buffer[0] = _buffer[1] = NULL;
+    }
+
+    void UploadWriter::task(void* pvParameters) {
+        UploadWriter* writer = (UploadWriter*)pvParameters;
+        block_t       block;
+        while (true) {
+            xQueueReceive(writer->_full, &block, portMAX_DELAY);
+            if (!writer->_failed && writer->_file->write(writer->_buffer[block.index], block.len) != block.len) {
+                writer->_failed = true;
+            }
+            xQueueSend(writer->_free, &block, portMAX_DELAY);
+        }
+    }
+
+    void UploadWriter::begin(File& file) {
+        if (_active) {
+            abort();
+        }
+        _file   = &file;
+        _failed = false;
+        _active = true;
+        _bytes  = 0;
+        _start  = millis();
+        if (_task == NULL) {
+            _free = xQueueCreate(2, sizeof(block_t));
+            _full = xQueueCreate(2, sizeof(block_t));
+            xTaskCreatePinnedToCore(task,           // task
+                                    "uploadTask",   // name for task
+                                    4096,           // size of task stack
+                                    this,           // parameters
+                                    1,              // priority
+                                    &_task,
+                                    SUPPORT_TASK_CORE  // core
+            );
+        }
+        _buffer[0] = (uint8_t*)malloc(BUFFER_SIZE);
+        _buffer[1] = (uint8_t*)malloc(BUFFER_SIZE);
+        _direct    = _buffer[0] == NULL || _buffer[1] == NULL;
+        if (_direct) {
+            free(_buffer[0]);
+            free(_buffer[1]);
+            _buffer[0] = _buffer[1] = NULL;
+            return;
+        }
+        block_t block = { 1, 0 };
+        xQueueSend(_free, &block, portMAX_DELAY);
+        _block = { 0, 0 };
+    }
+
+    bool UploadWriter::write(const uint8_t* data, size_t len) {
+        if (!_active) {
+            return false;
+        }
+        _bytes += len;
+        if (_direct) {
+            if (!_failed && _file->write(data, len) != len) {
+                _failed = true;
+            }
+            return !_failed;
+        }
+        while (len) {
+            size_t n = min(len, size_t(BUFFER_SIZE) - _block.len);
+            memcpy(_buffer[_block.index] + _block.len, data, n);
+            _block.len += n;
+            data += n;
+            len -= n;
+            if (_block.len == BUFFER_SIZE) {
+                xQueueSend(_full, &_block, portMAX_DELAY);
+                xQueueReceive(_free, &_block, portMAX_DELAY);  // Waits only if the card is slower than WiFi
+                _block.len = 0;
+            }
+        }
+        return !_failed;
+    }
+
+    // Hands over the buffer being filled and takes both buffers back once the task is done.
+    void UploadWriter::finish() {
+        if (!_direct) {
+            xQueueSend(_block.len ? _full : _free, &_block, portMAX_DELAY);
+            for (int i = 0; i < 2; i++) {
+                xQueueReceive(_free, &_block, portMAX_DELAY);
+            }
+            free(_buffer[0]);
+            free(_buffer[1]);
+            _buffer[0] = _buffer[1] = NULL;
+        }
+        _active = false;
+    }
+
+    bool UploadWriter::end() {
+        if (!_active) {
+            return false;
+        }
+        finish();
+        return !_failed;
+    }
+
+    void UploadWriter::abort() {
+        if (_active) {
+            _failed = true;  // The task skips whatever is still queued
+            finish();
+        }
+    }
+
+    float UploadWriter::rate() {
+        uint32_t elapsed = millis() - _start;
+        return elapsed ? _bytes / (elapsed * 1000.0f) : 0.0f;
+    }
+}
+#endif
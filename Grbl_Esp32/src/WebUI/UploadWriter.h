@@ -0,0 +1,75 @@
+#pragma once
+
+/*
+  UploadWriter.h - Buffered file writer for web uploads
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+namespace WebUI {
+    // Writes an upload to a file in large blocks from a task of its own. The chunks the
+    // HTTP server hands over, about 1.4 KB each, are collected into one of two buffers.
+    // A full buffer goes to the writer task while the other fills, so receiving over WiFi
+    // overlaps with writing to the card, and every write but the last is whole sectors.
+    class UploadWriter {
+    public:
+        static const int BUFFER_SIZE = 16384;  // A multiple of the 512-byte SD sector
+
+        UploadWriter();
+
+        // Starts an upload to file, which must stay open until end() or abort().
+        // Without memory for the buffers, data is written through unbuffered.
+        void begin(File& file);
+
+        // Adds upload data. Returns false once a write to the file has failed.
+        bool write(const uint8_t* data, size_t len);
+
+        // Writes what is still buffered and waits for the task to finish.
+        // Returns false if any write failed.
+        bool end();
+
+        // Drops what is still buffered and waits for the task to finish.
+        void abort();
+
+        // Average rate since begin(), in MB/s
+        float rate();
+
+    private:
+        typedef struct {
+            uint8_t index;  // Which of _buffer[] holds the data
+            size_t  len;
+        } block_t;
+
+        static void task(void* pvParameters);
+        void        finish();
+
+        TaskHandle_t  _task;
+        QueueHandle_t _free;  // Buffers ready to fill
+        QueueHandle_t _full;  // Buffers waiting to be written, in order
+        uint8_t*      _buffer[2];
+        block_t       _block;  // Buffer being filled
+        File*         _file;
+        volatile bool _failed;
+        bool          _active;
+        bool          _direct;  // Writing through, unbuffered
+        uint32_t      _bytes;
+        uint32_t      _start;
+    };
+}
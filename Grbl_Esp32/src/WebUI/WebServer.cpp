@@ -27,6 +27,7 @@
 #    include "ESPResponse.h"
 #    include "Serial2Socket.h"
 #    include "WebServer.h"
+#    include "UploadWriter.h"
 #    include <WebSocketsServer.h>
 #    include <WiFi.h>
 #    include <FS.h>
@@ -38,6 +39,7 @@
 #    include <WebServer.h>
 #    include <ESP32SSDP.h>
 #    include <StreamString.h>
+#    include <map>
 #    include <Update.h>
 #    include <esp_wifi_types.h>
 #    ifdef ENABLE_MDNS
@@ -84,7 +86,25 @@ namespace WebUI {
     const int ESP_ERROR_UPLOAD_CANCELLED = 6;
     const int ESP_ERROR_FILE_CLOSE       = 7;
 
+    // Size of each read from SD when sending a file
+    const int SD_DOWNLOAD_BUFFER_SIZE = 8192;
+
+    // Cache-Control for static files. Names with a content hash never change in place,
+    // anything else must be revalidated against its ETag before a cached copy is used.
+    const char CACHE_HASHED[]     = "public, max-age=31536000, immutable";
+    const char CACHE_REVALIDATE[] = "no-cache";
+
+    // A static file on SPIFFS, keyed by the path it is requested as
+    struct StaticFile {
+        String path;  // The file to send, the .gz variant when there is one
+        String etag;
+    };
+    static std::map<String, StaticFile> static_files;
+    static volatile bool                static_files_valid = false;
+
     Web_Server        web_server;
+    UploadWriter      upload_writer;
+    TaskHandle_t      Web_Server::_task          = NULL;
     bool              Web_Server::_setupdone     = false;
     uint16_t          Web_Server::_port          = 0;
     long              Web_Server::_id_connection = 0;
@@ -111,20 +131,21 @@ namespace WebUI {
 
         //create instance
         _webserver = new WebServer(_port);
-#    ifdef ENABLE_AUTHENTICATION
         //here the list of headers to be recorded
-        const char* headerkeys[]   = { "Cookie" };
-        size_t      headerkeyssize = sizeof(headerkeys) / sizeof(char*);
+        const char* headerkeys[] = {
+            "Range",
+            "If-None-Match",
+#    ifdef ENABLE_AUTHENTICATION
+            "Cookie",
+#    endif
+        };
+        size_t headerkeyssize = sizeof(headerkeys) / sizeof(char*);
         //ask server to track these headers
         _webserver->collectHeaders(headerkeys, headerkeyssize);
-#    endif
         _socket_server = new WebSocketsServer(_port + 1);
         _socket_server->begin();
         _socket_server->onEvent(handle_Websocket_Event);
 
-        //Websocket output
-        Serial2Socket.attachWS(_socket_server);
-
         //events functions
         //_web_events->onConnect(handle_onevent_connect);
         //events management
@@ -200,6 +221,19 @@ namespace WebUI {
         grbl_send(CLIENT_ALL, "[MSG:HTTP Started]\r\n");
         //start webserver
         _webserver->begin();
+        //serve clients from a task of its own so slow requests do not hold up command input
+        if (_task == NULL) {
+            xTaskCreatePinnedToCore(webServerTask,    // task
+                                    "webServerTask",  // name for task
+                                    8192,             // size of task stack
+                                    this,             // parameters
+                                    1,                // priority
+                                    &_task,
+                                    SUPPORT_TASK_CORE  // core
+            );
+        }
+        //Websocket output, sent from that task
+        Serial2Socket.attachWS(_socket_server, _task);
 #    ifdef ENABLE_MDNS
         //add mDNS
         if (WiFi.getMode() == WIFI_STA) {
@@ -239,26 +273,99 @@ namespace WebUI {
 #    endif
     }
 
+    //Static files on SPIFFS////////////////////////////////////////////////
+
+    //drops the index of static files, it is rebuilt on the next request
+    void Web_Server::invalidateStaticFiles() { static_files_valid = false; }
+
+    //lists SPIFFS once instead of probing for each file and its .gz variant on every request
+    void Web_Server::indexStaticFiles() {
+        static_files.clear();
+        File root = SPIFFS.open("/");
+        File file = root.openNextFile();
+        while (file) {
+            String path = file.name();
+            String key  = path;
+            bool   gz   = path.endsWith(".gz");
+            if (gz) {
+                key = path.substring(0, path.length() - 3);
+            }
+            //the .gz variant is preferred, as before
+            if (gz || static_files.find(key) == static_files.end()) {
+                char etag[24];
+                snprintf(etag, sizeof(etag), "\"%x-%lx\"", file.size(), (unsigned long)file.getLastWrite());
+                static_files[key] = { path, etag };
+            }
+            file.close();
+            file = root.openNextFile();
+        }
+        root.close();
+        static_files_valid = true;
+    }
+
+    //names like app.3f2a9c1b.js carry a hash of their content
+    static bool isHashedAsset(const String& path) {
+        int end   = path.lastIndexOf('.');
+        int start = end > 0 ? path.lastIndexOf('.', end - 1) : -1;
+        if (start < 0 || start < path.lastIndexOf('/') || end - start - 1 < 8) {
+            return false;
+        }
+        for (int i = start + 1; i < end; i++) {
+            if (!isxdigit(path[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //answers If-None-Match with 304, returns false if the client needs the content
+    bool Web_Server::sendValidators(const String& etag, const char* cacheControl) {
+        _webserver->sendHeader("ETag", etag);
+        _webserver->sendHeader("Cache-Control", cacheControl);
+        String match = _webserver->header("If-None-Match");
+        if (match.length() > 0 && (match == "*" || match.indexOf(etag) >= 0)) {
+            _webserver->send(304);
+            return true;
+        }
+        return false;
+    }
+
+    //sends a static file from SPIFFS, returns false if there is none for path
+    bool Web_Server::streamStaticFile(const String& path) {
+        if (!static_files_valid) {
+            indexStaticFiles();
+        }
+        auto entry = static_files.find(path);
+        if (entry == static_files.end()) {
+            return false;
+        }
+        if (sendValidators(entry->second.etag, isHashedAsset(path) ? CACHE_HASHED : CACHE_REVALIDATE)) {
+            return true;
+        }
+        File file = SPIFFS.open(entry->second.path, FILE_READ);
+        if (!file) {
+            //changed behind our back
+            invalidateStaticFiles();
+            return false;
+        }
+        _webserver->streamFile(file, getContentType(path));
+        file.close();
+        return true;
+    }
+
     //Root of Webserver/////////////////////////////////////////////////////
 
     void Web_Server::handle_root() {
-        String path        = "/index.html";
-        String contentType = getContentType(path);
-        String pathWithGz  = path + ".gz";
         //if have a index.html or gzip version this is default root page
-        if ((SPIFFS.exists(pathWithGz) || SPIFFS.exists(path)) && !_webserver->hasArg("forcefallback") &&
-            _webserver->arg("forcefallback") != "yes") {
-            if (SPIFFS.exists(pathWithGz)) {
-                path = pathWithGz;
-            }
-
-            File file = SPIFFS.open(path, FILE_READ);
-            _webserver->streamFile(file, contentType);
-            file.close();
+        if (!_webserver->hasArg("forcefallback") && _webserver->arg("forcefallback") != "yes" && streamStaticFile("/index.html")) {
             return;
         }
 
-        //if no lets launch the default content
+        //if no lets launch the default content, which only changes with the firmware
+        String etag = String("\"") + GRBL_VERSION_BUILD + "-" + String(PAGE_NOFILES_SIZE, HEX) + "\"";
+        if (sendValidators(etag, CACHE_REVALIDATE)) {
+            return;
+        }
         _webserver->sendHeader("Content-Encoding", "gzip");
         _webserver->send_P(200, "text/html", PAGE_NOFILES, PAGE_NOFILES_SIZE);
     }
@@ -285,6 +392,7 @@ namespace WebUI {
                 content += path + ", SD is not available.";
 
                 _webserver->send(500, "text/plain", content);
+                return;
             }
             if (SD.exists(pathWithGz) || SD.exists(path)) {
                 set_sd_state(SDState::BusyUploading);
@@ -293,31 +401,8 @@ namespace WebUI {
                 }
                 File datafile = SD.open(path);
                 if (datafile) {
-                    vTaskDelay(1 / portTICK_RATE_MS);
-                    size_t totalFileSize = datafile.size();
-                    size_t i             = 0;
-                    bool   done          = false;
-                    _webserver->setContentLength(totalFileSize);
-                    _webserver->send(200, contentType, "");
-                    uint8_t buf[1024];
-                    while (!done) {
-                        vTaskDelay(1 / portTICK_RATE_MS);
-                        int v = datafile.read(buf, 1024);
-                        if ((v == -1) || (v == 0)) {
-                            done = true;
-                        } else {
-                            _webserver->client().write(buf, 1024);
-                            i += v;
-                        }
-
-                        if (i >= totalFileSize) {
-                            done = true;
-                        }
-                    }
+                    streamSDFile(datafile, contentType);
                     datafile.close();
-                    if (i != totalFileSize) {
-                        //error: TBD
-                    }
                     set_sd_state(SDState::Idle);
                     return;
                 }
@@ -329,13 +414,7 @@ namespace WebUI {
             return;
         } else
 #    endif
-            if (SPIFFS.exists(pathWithGz) || SPIFFS.exists(path)) {
-            if (SPIFFS.exists(pathWithGz)) {
-                path = pathWithGz;
-            }
-            File file = SPIFFS.open(path, FILE_READ);
-            _webserver->streamFile(file, contentType);
-            file.close();
+            if (streamStaticFile(path)) {
             return;
         } else {
             page_not_found = true;
@@ -700,6 +779,9 @@ namespace WebUI {
             return;
         }
 
+        //uploads and the actions below change what is on SPIFFS
+        invalidateStaticFiles();
+
         String path;
         String status = "Ok";
         if (_upload_status == UploadStatusType::FAILED) {
@@ -814,16 +896,23 @@ namespace WebUI {
             }
         }
 
-        String jsonfile = "{";
-        String ptmp     = path;
+        String ptmp = path;
         if ((path != "/") && (path[path.length() - 1] = '/')) {
             ptmp = path.substring(0, path.length() - 1);
         }
 
+        //the list is sent as it is encoded, in chunks
+        ESPResponseStream out(_webserver, "application/json");
+        JSONencoder       j(false, &out);
+        j.begin();
         File dir = SPIFFS.open(ptmp);
-        jsonfile += "\"files\":[";
-        bool   firstentry = true;
-        String subdirlist = "";
+        j.begin_array("files");
+        //optional paging and name filter, as for SD
+        uint32_t offset     = _webserver->hasArg("offset") ? _webserver->arg("offset").toInt() : 0;
+        uint32_t limit      = _webserver->hasArg("limit") ? _webserver->arg("limit").toInt() : UINT32_MAX;
+        String   filter     = _webserver->arg("filter");
+        uint32_t matched    = 0;
+        String   subdirlist = "";
         File   fileparsed = dir.openNextFile();
         while (fileparsed) {
             String filename  = fileparsed.name();
@@ -856,38 +945,40 @@ namespace WebUI {
                     addtolist = false;
                 }
             }
+            //directories are kept so they can still be opened
+            if (addtolist && size != "-1" && filter.length() > 0) {
+                String lowername   = filename;
+                String lowerfilter = filter;
+                lowername.toLowerCase();
+                lowerfilter.toLowerCase();
+                addtolist = lowername.indexOf(lowerfilter) >= 0;
+            }
             if (addtolist) {
-                if (!firstentry) {
-                    jsonfile += ",";
-                } else {
-                    firstentry = false;
+                if (matched >= offset && matched - offset < limit) {
+                    j.begin_object();
+                    j.member("name", filename);
+                    j.member("size", size);
+                    j.end_object();
                 }
-                jsonfile += "{";
-                jsonfile += "\"name\":\"";
-                jsonfile += filename;
-                jsonfile += "\",\"size\":\"";
-                jsonfile += size;
-                jsonfile += "\"";
-                jsonfile += "}";
+                matched++;
             }
             fileparsed = dir.openNextFile();
         }
-        jsonfile += "],";
-        jsonfile += "\"path\":\"" + path + "\",";
-        jsonfile += "\"status\":\"" + status + "\",";
+        j.end_array();
+        j.member("path", path);
+        j.member("offset", offset);
+        j.member("count", matched);
+        j.member("status", status);
         size_t totalBytes;
         size_t usedBytes;
         totalBytes = SPIFFS.totalBytes();
         usedBytes  = SPIFFS.usedBytes();
-        jsonfile += "\"total\":\"" + ESPResponseStream::formatBytes(totalBytes) + "\",";
-        jsonfile += "\"used\":\"" + ESPResponseStream::formatBytes(usedBytes) + "\",";
-        jsonfile.concat(F("\"occupation\":\""));
-        jsonfile += String(100 * usedBytes / totalBytes);
-        jsonfile += "\"";
-        jsonfile += "}";
+        j.member("total", ESPResponseStream::formatBytes(totalBytes));
+        j.member("used", ESPResponseStream::formatBytes(usedBytes));
+        j.member("occupation", String(100 * usedBytes / totalBytes));
+        j.end();
+        out.flush();
         path = "";
-        _webserver->sendHeader("Cache-Control", "no-cache");
-        _webserver->send(200, "application/json", jsonfile);
     }
 
     //push error code and message to websocket
@@ -955,6 +1046,7 @@ namespace WebUI {
                         SPIFFS.remove(filename);
                     }
                     if (fsUploadFile) {
+                        upload_writer.abort();
                         fsUploadFile.close();
                     }
                     String sizeargname = upload.filename + "S";
@@ -975,6 +1067,7 @@ namespace WebUI {
                         if (fsUploadFile) {
                             //if yes upload is started
                             _upload_status = UploadStatusType::ONGOING;
+                            upload_writer.begin(fsUploadFile);
                         } else {
                             //if no set cancel flag
                             _upload_status = UploadStatusType::FAILED;
@@ -989,7 +1082,7 @@ namespace WebUI {
                     //check if file is available and no error
                     if (fsUploadFile && _upload_status == UploadStatusType::ONGOING) {
                         //no error so write post date
-                        if (upload.currentSize != fsUploadFile.write(upload.buf, upload.currentSize)) {
+                        if (!upload_writer.write(upload.buf, upload.currentSize)) {
                             _upload_status = UploadStatusType::FAILED;
                             grbl_send(CLIENT_ALL, "[MSG:Upload error]\r\n");
                             pushError(ESP_ERROR_FILE_WRITE, "File write failed");
@@ -1005,7 +1098,10 @@ namespace WebUI {
                 } else if (upload.status == UPLOAD_FILE_END) {
                     //check if file is still open
                     if (fsUploadFile) {
-                        //close it
+                        //write what is still buffered and close it
+                        if (!upload_writer.end()) {
+                            _upload_status = UploadStatusType::FAILED;
+                        }
                         fsUploadFile.close();
                         //check size
                         String sizeargname = upload.filename + "S";
@@ -1019,6 +1115,7 @@ namespace WebUI {
 
                         if (_upload_status == UploadStatusType::ONGOING) {
                             _upload_status = UploadStatusType::SUCCESSFUL;
+                            grbl_msg_sendf(CLIENT_ALL, MsgLevel::Info, "Uploaded %s at %.2f MB/s", filename.c_str(), upload_writer.rate());
                         } else {
                             grbl_send(CLIENT_ALL, "[MSG:Upload error]\r\n");
                             pushError(ESP_ERROR_UPLOAD, "File upload failed");
@@ -1033,6 +1130,7 @@ namespace WebUI {
                     //**************
                 } else {
                     _upload_status = UploadStatusType::FAILED;
+                    upload_writer.abort();
                     //pushError(ESP_ERROR_UPLOAD, "File upload failed");
                     return;
                 }
@@ -1041,6 +1139,10 @@ namespace WebUI {
 
         if (_upload_status == UploadStatusType::FAILED) {
             cancelUpload();
+            if (fsUploadFile) {
+                upload_writer.abort();
+                fsUploadFile.close();
+            }
             if (SPIFFS.exists(filename)) {
                 SPIFFS.remove(filename);
             }
@@ -1185,7 +1287,7 @@ namespace WebUI {
         if (!file.isDirectory()) {
             file.close();
             //return if success or not
-            return SD.remove(path);
+            return removeFile(SD, path.c_str());
         }
         file.rewindDirectory();
         while (true) {
@@ -1253,6 +1355,7 @@ namespace WebUI {
         }
         //check if query need some action
         if (_webserver->hasArg("action")) {
+            markSDChanged();
             //delete a file
             if (_webserver->arg("action") == "delete" && _webserver->hasArg("filename")) {
                 String filename;
@@ -1263,7 +1366,7 @@ namespace WebUI {
                 if (!SD.exists(filename)) {
                     sstatus = shortname + " does not exist!";
                 } else {
-                    if (SD.remove(filename)) {
+                    if (removeFile(SD, filename.c_str())) {
                         sstatus = shortname + " deleted";
                     } else {
                         sstatus = "Cannot deleted ";
@@ -1318,10 +1421,6 @@ namespace WebUI {
             list_files = false;
         }
 
-        // TODO Settings - consider using the JSONEncoder class
-        String jsonfile = "{";
-        jsonfile += "\"files\":[";
-
         if (path != "/") {
             path = path.substring(0, path.length() - 1);
         }
@@ -1334,45 +1433,33 @@ namespace WebUI {
             set_sd_state(SDState::Idle);
             return;
         }
+        //the list is sent as it is encoded, in chunks
+        ESPResponseStream out(_webserver, "application/json");
+        JSONencoder       j(false, &out);
+        j.begin();
+        j.begin_array("files");
+        //optional paging and name filter, the directory is read from the card only once
+        uint32_t offset  = _webserver->hasArg("offset") ? _webserver->arg("offset").toInt() : 0;
+        uint32_t limit   = _webserver->hasArg("limit") ? _webserver->arg("limit").toInt() : UINT32_MAX;
+        String   filter  = _webserver->arg("filter");
+        uint32_t matched = 0;
         if (list_files) {
-            File dir = SD.open(path);
-            if (!dir.isDirectory()) {
-                dir.close();
-            }
-            dir.rewindDirectory();
-            File entry = dir.openNextFile();
-            int  i     = 0;
-            while (entry) {
-                COMMANDS::wait(1);
-                if (i > 0) {
-                    jsonfile += ",";
-                }
-                jsonfile += "{\"name\":\"";
-                String tmpname = entry.name();
-                int    pos     = tmpname.lastIndexOf("/");
-                tmpname        = tmpname.substring(pos + 1);
-                jsonfile += tmpname;
-                jsonfile += "\",\"shortname\":\"";  //No need here
-                jsonfile += tmpname;
-                jsonfile += "\",\"size\":\"";
-                if (entry.isDirectory()) {
-                    jsonfile += "-1";
-                } else {
-                    // files have sizes, directories do not
-                    jsonfile += ESPResponseStream::formatBytes(entry.size());
-                }
-                jsonfile += "\",\"datetime\":\"";
+            matched = listDirPage(path.c_str(), filter.c_str(), offset, limit, [&](const char* name, bool directory, uint32_t size) {
+                COMMANDS::wait(0);
+                j.begin_object();
+                j.member("name", name);
+                j.member("shortname", name);  //No need here
+                // files have sizes, directories do not
+                j.member("size", directory ? String("-1") : ESPResponseStream::formatBytes(size));
                 //TODO - can be done later
-                jsonfile += "\"}";
-                i++;
-                entry.close();
-                entry = dir.openNextFile();
-            }
-            dir.close();
-        }
-        jsonfile += "],\"path\":\"";
-        jsonfile += path + "\",";
-        jsonfile += "\"total\":\"";
+                j.member("datetime", "");
+                j.end_object();
+            });
+        }
+        j.end_array();
+        j.member("path", path);
+        j.member("offset", offset);
+        j.member("count", matched);
         String stotalspace, susedspace;
         //SDCard are in GB or MB but no less
         totalspace  = SD.totalBytes();
@@ -1388,30 +1475,107 @@ namespace WebUI {
         if (occupedspace <= 1) {
             occupedspace = 1;
         }
-        if (totalspace) {
-            jsonfile += stotalspace;
-        } else {
-            jsonfile += "-1";
-        }
-        jsonfile += "\",\"used\":\"";
-        jsonfile += susedspace;
-        jsonfile += "\",\"occupation\":\"";
-        if (totalspace) {
-            jsonfile += String(occupedspace);
-        } else {
-            jsonfile += "-1";
-        }
-        jsonfile += "\",";
-        jsonfile += "\"mode\":\"direct\",";
-        jsonfile += "\"status\":\"";
-        jsonfile += sstatus + "\"";
-        jsonfile += "}";
-        _webserver->sendHeader("Cache-Control", "no-cache");
-        _webserver->send(200, "application/json", jsonfile);
+        j.member("total", totalspace ? stotalspace : String("-1"));
+        j.member("used", susedspace);
+        j.member("occupation", totalspace ? String(occupedspace) : String("-1"));
+        j.member("mode", "direct");
+        j.member("status", sstatus);
+        j.end();
+        out.flush();
         set_sd_state(SDState::Idle);
         SD.end();
     }
 
+    //true for a non-empty run of decimal digits
+    static bool isDigits(const String& s) {
+        if (s.length() == 0) {
+            return false;
+        }
+        for (size_t i = 0; i < s.length(); i++) {
+            if (!isdigit(s[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //SD File download, whole or from a Range header///////////////////////
+    //client().write() copies into the TCP send buffer and returns, so the next
+    //read from SD overlaps with the previous one going out over WiFi
+    void Web_Server::streamSDFile(File& file, const String& contentType) {
+        size_t fileSize = file.size();
+        size_t start    = 0;
+        size_t end      = fileSize;  // One past the last byte to send
+        bool   partial  = false;
+        //only a single range is honored, for more the whole file is sent
+        //a range that is not well formed is ignored and the whole file is sent
+        String range = _webserver->header("Range");
+        int    dash  = range.indexOf('-');
+        if (range.startsWith("bytes=") && dash > 0 && range.indexOf(',') < 0) {
+            String first    = range.substring(6, dash);
+            String last     = range.substring(dash + 1);
+            bool   hasFirst = isDigits(first);
+            bool   hasLast  = isDigits(last);
+            if (hasFirst && (hasLast || last.length() == 0)) {
+                start = strtoul(first.c_str(), NULL, 10);
+                if (hasLast) {
+                    size_t lastByte = strtoul(last.c_str(), NULL, 10);
+                    partial         = lastByte >= start;
+                    end             = lastByte < fileSize ? lastByte + 1 : fileSize;
+                } else {
+                    partial = true;
+                }
+            } else if (first.length() == 0 && hasLast) {
+                //suffix range, the last bytes of the file
+                size_t count = strtoul(last.c_str(), NULL, 10);
+                start        = count < fileSize ? fileSize - count : 0;
+                partial      = true;
+                if (count == 0) {
+                    start = fileSize;  //bytes=-0 selects nothing
+                }
+            }
+            if (!partial) {
+                start = 0;
+                end   = fileSize;
+            } else if (start >= fileSize) {
+                _webserver->sendHeader("Content-Range", "bytes */" + String(fileSize));
+                _webserver->send(416, "text/plain", "Range not satisfiable");
+                return;
+            }
+        }
+        if (!file.seek(start)) {
+            _webserver->send(500, "text/plain", "Read error");
+            return;
+        }
+
+        _webserver->sendHeader("Accept-Ranges", "bytes");
+        if (partial) {
+            _webserver->sendHeader("Content-Range", "bytes " + String(start) + "-" + String(end - 1) + "/" + String(fileSize));
+        }
+        _webserver->setContentLength(end - start);
+        _webserver->send(partial ? 206 : 200, contentType, "");
+
+        uint8_t  fallback[1024];
+        size_t   bufSize = SD_DOWNLOAD_BUFFER_SIZE;
+        uint8_t* buf     = (uint8_t*)malloc(bufSize);
+        if (buf == NULL) {
+            buf     = fallback;
+            bufSize = sizeof(fallback);
+        }
+        WiFiClient client    = _webserver->client();
+        size_t     remaining = end - start;
+        while (remaining > 0 && client.connected()) {
+            int len = file.read(buf, min(bufSize, remaining));
+            if (len <= 0 || client.write(buf, len) != size_t(len)) {
+                break;
+            }
+            remaining -= len;
+        }
+        if (buf != fallback) {
+            free(buf);
+        }
+    }
+
     //SD File upload with direct access to SD///////////////////////////////
     void Web_Server::SDFile_direct_upload() {
         static String filename;
@@ -1442,10 +1606,8 @@ namespace WebUI {
 
                     } else {
                         set_sd_state(SDState::BusyUploading);
-                        //delete file on SD Card if already present
-                        if (SD.exists(filename)) {
-                            SD.remove(filename);
-                        }
+                        //delete file on SD Card if already present, and what was made from a file of that name
+                        removeFile(SD, filename.c_str());
                         String sizeargname = upload.filename + "S";
                         if (_webserver->hasArg(sizeargname)) {
                             uint32_t filesize  = _webserver->arg(sizeargname).toInt();
@@ -1459,6 +1621,7 @@ namespace WebUI {
                         if (_upload_status != UploadStatusType::FAILED) {
                             //Create file for writing
                             sdUploadFile = SD.open(filename, FILE_WRITE);
+                            markSDChanged();
                             //check if creation succeed
                             if (!sdUploadFile) {
                                 //if creation failed
@@ -1469,6 +1632,7 @@ namespace WebUI {
                             //if creation succeed set flag UploadStatusType::ONGOING
                             else {
                                 _upload_status = UploadStatusType::ONGOING;
+                                upload_writer.begin(sdUploadFile);
                             }
                         }
                     }
@@ -1478,7 +1642,7 @@ namespace WebUI {
                     vTaskDelay(1 / portTICK_RATE_MS);
                     if (sdUploadFile && (_upload_status == UploadStatusType::ONGOING) && (get_sd_state(false) == SDState::BusyUploading)) {
                         //no error write post data
-                        if (upload.currentSize != sdUploadFile.write(upload.buf, upload.currentSize)) {
+                        if (!upload_writer.write(upload.buf, upload.currentSize)) {
                             _upload_status = UploadStatusType::FAILED;
                             grbl_send(CLIENT_ALL, "[MSG:Upload failed]\r\n");
                             pushError(ESP_ERROR_FILE_WRITE, "File write failed");
@@ -1493,7 +1657,13 @@ namespace WebUI {
                 } else if (upload.status == UPLOAD_FILE_END) {
                     //if file is open close it
                     if (sdUploadFile) {
+                        //write what is still buffered and close it
+                        if (!upload_writer.end()) {
+                            _upload_status = UploadStatusType::FAILED;
+                            pushError(ESP_ERROR_FILE_WRITE, "File write failed");
+                        }
                         sdUploadFile.close();
+                        markSDChanged();
                         //TODO Check size
                         String sizeargname = upload.filename + "S";
                         if (_webserver->hasArg(sizeargname)) {
@@ -1515,6 +1685,7 @@ namespace WebUI {
                     if (_upload_status == UploadStatusType::ONGOING) {
                         _upload_status = UploadStatusType::SUCCESSFUL;
                         set_sd_state(SDState::Idle);
+                        grbl_msg_sendf(CLIENT_ALL, MsgLevel::Info, "Uploaded %s at %.2f MB/s", filename.c_str(), upload_writer.rate());
                     } else {
                         _upload_status = UploadStatusType::FAILED;
                         pushError(ESP_ERROR_UPLOAD, "Upload error");
@@ -1525,6 +1696,7 @@ namespace WebUI {
                     set_sd_state(SDState::Idle);
                     grbl_send(CLIENT_ALL, "[MSG:Upload failed]\r\n");
                     if (sdUploadFile) {
+                        upload_writer.abort();
                         sdUploadFile.close();
                     }
                     SD.end();
@@ -1535,17 +1707,39 @@ namespace WebUI {
         if (_upload_status == UploadStatusType::FAILED) {
             cancelUpload();
             if (sdUploadFile) {
+                upload_writer.abort();
                 sdUploadFile.close();
             }
             if (SD.exists(filename)) {
                 SD.remove(filename);
             }
+            markSDChanged();
             set_sd_state(SDState::Idle);
         }
         COMMANDS::wait(0);
     }
 #    endif
 
+    // Runs HTTP and WebSocket clients apart from clientCheckTask, which moves serial
+    // and telnet input into the line buffers. Web commands still reach the protocol
+    // loop through Serial2Socket, whose receive buffer is shared under a lock. Output
+    // for the WebSocket is only buffered by its writers and is sent from here.
+    void Web_Server::webServerTask(void* pvParameters) {
+        Web_Server* server = (Web_Server*)pvParameters;
+        while (true) {
+            server->handle();
+#    ifdef ENABLE_SERIAL2SOCKET_OUT
+            Serial2Socket.handle_flush();
+#    endif
+            ulTaskNotifyTake(pdTRUE, 1 / portTICK_RATE_MS);  // Yield to other tasks, or wake for Serial2Socket output
+
+            static UBaseType_t uxHighWaterMark = 0;
+#    ifdef DEBUG_TASK_STACK
+            reportTaskStackSize(uxHighWaterMark);
+#    endif
+        }
+    }
+
     void Web_Server::handle() {
         static uint32_t timeout = millis();
         COMMANDS::wait(0);
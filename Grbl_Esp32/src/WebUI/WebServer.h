@@ -22,6 +22,7 @@
 
 #include "../Config.h"
 #include "Commands.h"
+#include <FS.h>
 
 class WebSocketsServer;
 class WebServer;
@@ -51,10 +52,14 @@ namespace WebUI {
 
         static long     get_client_ID();
         static uint16_t port() { return _port; }
+        static void     invalidateStaticFiles();
 
         ~Web_Server();
 
     private:
+        static void webServerTask(void* pvParameters);
+
+        static TaskHandle_t        _task;
         static bool                _setupdone;
         static WebServer*          _webserver;
         static long                _id_connection;
@@ -76,6 +81,9 @@ namespace WebUI {
 #ifdef ENABLE_SSDP
         static void handle_SSDP();
 #endif
+        static void indexStaticFiles();
+        static bool sendValidators(const String& etag, const char* cacheControl);
+        static bool streamStaticFile(const String& path);
         static void handle_root();
         static void handle_login();
         static void handle_not_found();
@@ -92,6 +100,7 @@ namespace WebUI {
 #ifdef ENABLE_SD_CARD
         static void handle_direct_SDFileList();
         static void SDFile_direct_upload();
+        static void streamSDFile(File& file, const String& contentType);
         static bool deleteRecursive(String path);
 #endif
     };
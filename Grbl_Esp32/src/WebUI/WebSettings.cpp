@@ -287,6 +287,9 @@ namespace WebUI {
         }
         webPrint("Formatting");
         SPIFFS.format();
+#if defined(ENABLE_WIFI) && defined(ENABLE_HTTP)
+        web_server.invalidateStaticFiles();
+#endif
         webPrintln("...Done");
         return Error::Ok;
     }
@@ -387,7 +390,7 @@ namespace WebUI {
             webPrintln("Invalid message!");
             return Error::InvalidValue;
         }
-        if (!notificationsservice.sendMSG("GRBL Notification", parameter)) {
+        if (!notificationsservice.queueMSG("GRBL Notification", parameter)) {
             webPrintln("Cannot send message!");
             return Error::MessageFailed;
         }
@@ -603,7 +606,7 @@ namespace WebUI {
 
 #ifdef ENABLE_WIFI
     static Error listAPs(char* parameter, AuthenticationLevel auth_level) {  // ESP410
-        JSONencoder j(espresponse->client() != CLIENT_WEBUI);
+        JSONencoder j(espresponse->client() != CLIENT_WEBUI, espresponse);
         j.begin();
         j.begin_array("AP_LIST");
         // An initial async scanNetworks was issued at startup, so there
@@ -634,7 +637,7 @@ namespace WebUI {
                 break;
         }
         j.end_array();
-        webPrint(j.end());
+        j.end();
         if (espresponse->client() != CLIENT_WEBUI) {
             espresponse->println("");
         }
@@ -659,7 +662,7 @@ namespace WebUI {
     }
 
     static Error listSettings(char* parameter, AuthenticationLevel auth_level) {  // ESP400
-        JSONencoder j(espresponse->client() != CLIENT_WEBUI);
+        JSONencoder j(espresponse->client() != CLIENT_WEBUI, espresponse);
         j.begin();
         j.begin_array("EEPROM");
         for (Setting* js = Setting::List; js; js = js->next()) {
@@ -668,12 +671,12 @@ namespace WebUI {
             }
         }
         j.end_array();
-        webPrint(j.end());
+        j.end();
         return Error::Ok;
     }
 
 #ifdef ENABLE_SD_CARD
-    static Error openSDFile(char* parameter) {
+    static Error openSDFile(char* parameter, bool job = false) {
         if (*parameter == '\0') {
             webPrintln("Missing file name!");
             return Error::InvalidValue;
@@ -692,7 +695,7 @@ namespace WebUI {
                 return Error::FsFailedBusy;
             }
         }
-        if (!openFile(SD, path.c_str())) {
+        if (!(job ? openJobFile(SD, path.c_str()) : openFile(SD, path.c_str()))) {
             report_status_message(Error::FsFailedRead, (espresponse) ? espresponse->client() : CLIENT_ALL);
             webPrintln("");
             return Error::FsFailedOpenFile;
@@ -708,8 +711,8 @@ namespace WebUI {
             return err;
         }
         SD_client = (espresponse) ? espresponse->client() : CLIENT_ALL;
-        char fileLine[255];
-        while (readFileLine(fileLine, 255)) {
+        char fileLine[SD_LINE_MAX + 1];
+        while (readFileLine(fileLine, SD_LINE_MAX)) {
             webPrintln(fileLine);
         }
         webPrintln("");
@@ -727,25 +730,138 @@ namespace WebUI {
             webPrintln("Busy");
             return Error::IdleError;
         }
-        if ((err = openSDFile(parameter)) != Error::Ok) {
+        // An optional ",<line>" after the file name restarts the job at that line
+        uint32_t start_line = 1;
+        char*    comma      = strrchr(parameter, ',');
+        if (comma) {
+            char*    end;
+            uint32_t line = strtoul(comma + 1, &end, 10);
+            if (line > 0 && end != comma + 1 && *trim(end) == '\0') {
+                start_line = line;
+                *comma     = '\0';
+            }
+        }
+        if ((err = openSDFile(parameter, true)) != Error::Ok) {
             return err;
         }
-        char fileLine[255];
-        if (!readFileLine(fileLine, 255)) {
+        SD_client     = (espresponse) ? espresponse->client() : CLIENT_ALL;
+        SD_auth_level = auth_level;
+        if (start_line > 1) {
+            // The protocol loop replays the job up to the line, then runs it from there
+            SD_restart_line = start_line;
+            SD_ready_next   = true;
+            webPrintln("");
+            return Error::Ok;
+        }
+        // execute the first line now; Protocol.cpp handles later ones when SD_ready_next
+        if (!executeFileLine(&err)) {
             //No need notification here it is just a macro
             closeFile();
             webPrintln("");
             return Error::Ok;
         }
+        report_status_message(err, SD_client);
+        report_realtime_status(SD_client);
+        webPrintln("");
+        return Error::Ok;
+    }
+
+    static Error compileSDFile(char* parameter, AuthenticationLevel auth_level) {  // ESP222
+        parameter = trim(parameter);
+        if (*parameter == '\0') {
+            webPrintln("Missing file name!");
+            return Error::InvalidValue;
+        }
+        SDState state = get_sd_state(true);
+        if (state != SDState::Idle) {
+            webPrintln((state == SDState::NotPresent) ? "No SD card" : "Busy");
+            return (state == SDState::NotPresent) ? Error::FsFailedMount : Error::FsFailedBusy;
+        }
+        String path = parameter;
+        if (parameter[0] != '/') {
+            path = "/" + path;
+        }
+        set_sd_state(SDState::BusyParsing);
+        Error err = compileFile(SD, path.c_str());
+        set_sd_state(SDState::Idle);
+        webPrintln((err == Error::Ok) ? "File compiled." : "Cannot compile file!");
+        return err;
+    }
+
+    static Error queueSDFile(char* parameter, AuthenticationLevel auth_level) {  // ESP223
+        parameter = trim(parameter);
+        if (*parameter == '\0') {
+            webPrintln("Missing file name!");
+            return Error::InvalidValue;
+        }
+        // Files can be added while a job runs
+        SDState state = get_sd_state(true);
+        if (state != SDState::Idle && state != SDState::BusyPrinting) {
+            webPrintln((state == SDState::NotPresent) ? "No SD card" : "Busy");
+            return (state == SDState::NotPresent) ? Error::FsFailedMount : Error::FsFailedBusy;
+        }
+        String path = parameter;
+        if (parameter[0] != '/') {
+            path = "/" + path;
+        }
+        Error err = queueAddFile(SD, path.c_str());
+        switch (err) {
+            case Error::Ok:
+                webPrintln("Queued ", path);
+                break;
+            case Error::Overflow:
+                webPrintln("Queue full!");
+                break;
+            default:
+                webPrintln("Cannot stat file!");
+                break;
+        }
+        return err;
+    }
+
+    static Error listSDQueue(char* parameter, AuthenticationLevel auth_level) {  // ESP224
+        for (uint8_t i = 0; i < queueCount(); i++) {
+            webPrintln("[QUEUE:" + String(i + 1) + "|FILE:" + queueFile(i) + "]");
+        }
+        return Error::Ok;
+    }
+
+    static Error runSDQueue(char* parameter, AuthenticationLevel auth_level) {  // ESP225
+        parameter = trim(parameter);
+        bool gate = strcasecmp(parameter, "PAUSE") == 0;
+        if (*parameter != '\0' && !gate) {
+            webPrintln("Invalid parameter!");
+            return Error::InvalidValue;
+        }
+        if (sys.state != State::Idle) {
+            webPrintln((sys.state == State::Alarm) ? "Alarm" : "Busy");
+            return Error::IdleError;
+        }
+        if (queueCount() == 0) {
+            webPrintln("Queue is empty");
+            return Error::Ok;
+        }
+        SDState state = get_sd_state(true);
+        if (state != SDState::Idle) {
+            webPrintln((state == SDState::NotPresent) ? "No SD card" : "Busy");
+            return (state == SDState::NotPresent) ? Error::FsFailedMount : Error::FsFailedBusy;
+        }
+        if (!queueRun(SD, gate)) {
+            webPrintln("Cannot open file!");
+            return Error::FsFailedOpenFile;
+        }
         SD_client     = (espresponse) ? espresponse->client() : CLIENT_ALL;
         SD_auth_level = auth_level;
-        // execute the first line now; Protocol.cpp handles later ones when SD_ready_next
-        report_status_message(execute_line(fileLine, SD_client, SD_auth_level), SD_client);
-        report_realtime_status(SD_client);
+        SD_ready_next = true;  // Protocol.cpp runs the lines
         webPrintln("");
         return Error::Ok;
     }
 
+    static Error clearSDQueue(char* parameter, AuthenticationLevel auth_level) {  // ESP226
+        queueClear();
+        return Error::Ok;
+    }
+
     static Error deleteSDObject(char* parameter, AuthenticationLevel auth_level) {  // ESP215
         parameter = trim(parameter);
         if (*parameter == '\0') {
@@ -766,6 +882,7 @@ namespace WebUI {
             webPrintln("Cannot stat file!");
             return Error::FsFileNotFound;
         }
+        markSDChanged();
         if (file2del.isDirectory()) {
             if (!SD.rmdir(path)) {
                 webPrintln("Cannot delete directory! Is directory empty?");
@@ -773,7 +890,7 @@ namespace WebUI {
             }
             webPrintln("Directory deleted.");
         } else {
-            if (!SD.remove(path)) {
+            if (!removeFile(SD, path.c_str())) {
                 webPrintln("Cannot delete file!");
                 return Error::FsFailedDelFile;
             }
@@ -783,6 +900,53 @@ namespace WebUI {
         return Error::Ok;
     }
 
+    static Error listSDPage(char* parameter, AuthenticationLevel auth_level) {  // ESP227
+        if (!split_params(parameter)) {
+            return Error::InvalidValue;
+        }
+        char*    path   = get_param("path", false);
+        char*    filter = get_param("filter", false);
+        char*    offset = get_param("offset", false);
+        char*    limit  = get_param("limit", false);
+        uint32_t first  = *offset ? strtoul(offset, NULL, 10) : 0;
+        uint32_t count  = *limit ? strtoul(limit, NULL, 10) : UINT32_MAX;
+        String   dir    = *path ? path : "/";
+        if (dir[0] != '/') {
+            dir = "/" + dir;
+        }
+        //further pages of a directory that was just listed come from the cache, without mounting the card
+        SDState state  = get_sd_state(false);  // Sees a change of the card detect pin first
+        bool    cached = state == SDState::Idle && isDirCached(dir.c_str());
+        if (!cached) {
+            state = get_sd_state(true);
+        }
+        if (state != SDState::Idle) {
+            webPrintln((state == SDState::NotPresent) ? "No SD card" : "Busy");
+            return (state == SDState::NotPresent) ? Error::FsFailedMount : Error::FsFailedBusy;
+        }
+        JSONencoder j(espresponse->client() != CLIENT_WEBUI, espresponse);
+        j.begin();
+        j.begin_array("files");
+        uint32_t matched = listDirPage(dir.c_str(), filter, first, count, [&](const char* name, bool directory, uint32_t size) {
+            j.begin_object();
+            j.member("name", name);
+            j.member("size", directory ? -1 : int(size));
+            j.end_object();
+        });
+        j.end_array();
+        j.member("path", dir);
+        j.member("offset", first);
+        j.member("count", matched);
+        j.end();
+        if (espresponse->client() != CLIENT_WEBUI) {
+            webPrintln("");
+        }
+        if (!cached) {
+            SD.end();
+        }
+        return Error::Ok;
+    }
+
     static Error listSDFiles(char* parameter, AuthenticationLevel auth_level) {  // ESP210
         SDState state = get_sd_state(true);
         if (state != SDState::Idle) {
@@ -864,7 +1028,7 @@ namespace WebUI {
     }
 
     static Error listLocalFilesJSON(char* parameter, AuthenticationLevel auth_level) {  // No ESP command
-        JSONencoder j(espresponse->client() != CLIENT_WEBUI);
+        JSONencoder j(espresponse->client() != CLIENT_WEBUI, espresponse);
         j.begin();
         j.begin_array("files");
         listDirJSON(SPIFFS, "/", 4, &j);
@@ -872,7 +1036,7 @@ namespace WebUI {
         j.member("total", SPIFFS.totalBytes());
         j.member("used", SPIFFS.usedBytes());
         j.member("occupation", String(100 * SPIFFS.usedBytes() / SPIFFS.totalBytes()));
-        webPrint(j.end());
+        j.end();
         if (espresponse->client() != CLIENT_WEBUI) {
             webPrintln("");
         }
@@ -1079,8 +1243,14 @@ namespace WebUI {
         new WebCommand(NULL, WEBCMD, WU, "ESP400", "WebUI/List", listSettings, anyState);
 #endif
 #ifdef ENABLE_SD_CARD
+        new WebCommand("path=dir offset=n limit=n filter=text", WEBCMD, WU, "ESP227", "SD/ListPage", listSDPage);
+        new WebCommand(NULL, WEBCMD, WU, "ESP226", "Queue/Clear", clearSDQueue, anyState);
+        new WebCommand("[PAUSE]", WEBCMD, WU, "ESP225", "Queue/Run", runSDQueue);
+        new WebCommand(NULL, WEBCMD, WU, "ESP224", "Queue/List", listSDQueue, anyState);
+        new WebCommand("path", WEBCMD, WU, "ESP223", "Queue/Add", queueSDFile, anyState);
+        new WebCommand("path", WEBCMD, WU, "ESP222", "SD/Compile", compileSDFile);
         new WebCommand("path", WEBCMD, WU, "ESP221", "SD/Show", showSDFile);
-        new WebCommand("path", WEBCMD, WU, "ESP220", "SD/Run", runSDFile);
+        new WebCommand("path[,line]", WEBCMD, WU, "ESP220", "SD/Run", runSDFile);
         new WebCommand("file_or_directory_path", WEBCMD, WU, "ESP215", "SD/Delete", deleteSDObject);
         new WebCommand(NULL, WEBCMD, WU, "ESP210", "SD/List", listSDFiles);
 #endif
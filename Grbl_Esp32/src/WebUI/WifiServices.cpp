@@ -159,9 +159,6 @@ namespace WebUI {
 #    ifdef ENABLE_OTA
         ArduinoOTA.handle();
 #    endif
-#    ifdef ENABLE_HTTP
-        web_server.handle();
-#    endif
 #    ifdef ENABLE_TELNET
         telnet_server.handle();
 #    endif
@@ -0,0 +1,22 @@
+; paste with a terminal emulator with a 200 ms delay between lines
+; number formats and out of range words; expected results are in the comments
+G21 G90 G94
+G0 X000000000123 (ok, X is 123)
+?
+G0 X0.00000000000000000001 (ok, X is 0)
+?
+G0 X0
+G0 X12345678901234567890 (ok or soft limit, X keeps its first 8 digits)
+G0 X0
+G0 X1000000000000000000000000000000000000000 (error:2, too large for a float)
+G0 X. (error:2)
+G0 X- (error:2)
+G0 X+.5 (ok)
+G0 X0
+G1000 (error:20)
+G-1 (error:20)
+M100000000000000000000 (error:20)
+G10 L100000 P1 X0 (error:38)
+N100000000000000000000 G0 X0 (error:27)
+N-5 G0 X0 (error:4)
+T1000000000000 (error:38)
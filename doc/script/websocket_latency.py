@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""\
+WebSocket round-trip latency check for Grbl_ESP32
+
+Sends lines the way the web UI does, as /command requests over HTTP,
+and times how long each takes to be answered with 'ok' or 'error' on
+the web UI's WebSocket, which listens one port above the web server.
+Use it to see how quickly Serial2Socket passes responses back. The
+socket_bench program in tests/ times the Serial2Socket part alone on a
+computer.
+
+Needs the websocket-client package:  pip install websocket-client
+
+Usage:  websocket_latency.py [-p 80] [-n 100] [-l '$G'] host
+"""
+
+import argparse
+import statistics
+import time
+import urllib.parse
+import urllib.request
+
+import websocket
+
+parser = argparse.ArgumentParser(description='Time ok/error responses on the Grbl_ESP32 web UI WebSocket.')
+parser.add_argument('host', help='address of the controller')
+parser.add_argument('-p', '--port', type=int, default=80, help='web server port, the WebSocket is one above')
+parser.add_argument('-n', '--count', type=int, default=100, help='number of lines to send')
+parser.add_argument('-l', '--line', default='$G', help='line to send, one response expected per line')
+args = parser.parse_args()
+
+ws = websocket.create_connection('ws://%s:%d/' % (args.host, args.port + 1), subprotocols=['arduino'])
+ws.settimeout(5)
+url = 'http://%s:%d/command?%s' % (args.host, args.port, urllib.parse.urlencode({'commandText': args.line}))
+
+pending = ''
+times = []
+for i in range(args.count):
+    start = time.monotonic()
+    urllib.request.urlopen(url).read()
+    answered = False
+    while not answered:
+        opcode, data = ws.recv_data()
+        if opcode != websocket.ABNF.OPCODE_BINARY:
+            continue  # Text frames carry web UI housekeeping such as PING
+        pending += data.decode(errors='replace')
+        while '\n' in pending:
+            response, pending = pending.split('\n', 1)
+            response = response.strip()
+            if response == 'ok' or response.startswith('error'):
+                answered = True
+    times.append((time.monotonic() - start) * 1000)
+    print('%4d  %7.1f ms' % (i + 1, times[-1]))
+
+ws.close()
+print('lines %d  min %.1f  median %.1f  max %.1f ms' % (len(times), min(times), statistics.median(times), max(times)))
@@ -124,6 +124,16 @@ bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * pay
     }
 
 #ifdef WEBSOCKETS_USE_BIG_MEM
+    // small frames are packed on the stack, no allocation needed
+    // callers sending often should reserve the header in their own buffer (headerToPayload)
+    uint8_t stackFrame[WEBSOCKETS_MAX_HEADER_SIZE + WEBSOCKETS_STACK_FRAME_SIZE];
+    if(!headerToPayload && (length > 0) && (length <= WEBSOCKETS_STACK_FRAME_SIZE)) {
+        memcpy((stackFrame + WEBSOCKETS_MAX_HEADER_SIZE), payload, length);
+        headerToPayload = true;
+        useInternBuffer = true;
+        payloadPtr = stackFrame;
+    }
+
     // only for ESP since AVR has less HEAP
     // try to send data in one TCP package (only if some free Heap is there)
     if(!headerToPayload && ((length > 0) && (length < 1400)) && (GET_FREE_HEAP > 6000)) {
@@ -256,7 +266,7 @@ bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * pay
     DEBUG_WEBSOCKETS("[WS][%d][sendFrame] sending Frame Done (%luus).\n", client->num, (micros() - start));
 
 #ifdef WEBSOCKETS_USE_BIG_MEM
-    if(useInternBuffer && payloadPtr) {
+    if(useInternBuffer && payloadPtr && payloadPtr != stackFrame) {
         free(payloadPtr);
     }
 #endif
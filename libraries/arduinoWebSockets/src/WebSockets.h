@@ -90,6 +90,9 @@
 // max size of the WS Message Header
 #define WEBSOCKETS_MAX_HEADER_SIZE  (14)
 
+// frames up to this size are packed into one TCP package on the stack instead of the heap
+#define WEBSOCKETS_STACK_FRAME_SIZE  (128)
+
 #if !defined(WEBSOCKETS_NETWORK_TYPE)
 // select Network type based
 #if defined(ESP8266) || defined(ESP31B)
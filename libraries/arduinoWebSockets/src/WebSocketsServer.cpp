@@ -52,6 +52,7 @@ WebSocketsServer::WebSocketsServer(uint16_t port, String origin, String protocol
 WebSocketsServer::~WebSocketsServer() {
     // disconnect all clients
 	close();
+    delete _server;
 
     if (_mandatoryHttpHeaders)
         delete[] _mandatoryHttpHeaders;
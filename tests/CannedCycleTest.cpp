@@ -0,0 +1,185 @@
+/*
+  CannedCycleTest.cpp - Tests of the G73/G81/G82/G83 canned cycles in GCode.cpp
+  Part of Grbl_ESP32
+
+  The motion the parser generates is compared with a reference expansion of
+  each cycle, written from the LinuxCNC description of the cycles.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+// One step of a cycle: a move to x, y, z, or a dwell
+struct Step {
+    bool    dwell;
+    bool    rapid;
+    float   x, y, z;
+    int32_t milliseconds;
+};
+
+static std::string format(const std::vector<Step>& steps) {
+    std::ostringstream out;
+    for (auto& step : steps) {
+        if (step.dwell) {
+            out << "dwell " << step.milliseconds << "\n";
+        } else {
+            out << (step.rapid ? "G0" : "G1") << " X" << step.x << " Y" << step.y << " Z" << step.z << "\n";
+        }
+    }
+    return out.str();
+}
+
+// The parser's motion, in the same form. Moves that go nowhere are left out, as the planner drops them.
+static std::vector<Step> recorded(float x, float y, float z) {
+    std::vector<Step> steps;
+    for (auto& record : host_motion) {
+        if (record.kind == MotionRecord::Kind::Dwell) {
+            steps.push_back({ true, false, 0, 0, 0, record.milliseconds });
+            continue;
+        }
+        EXPECT_EQ(MotionRecord::Kind::Line, record.kind);
+        const float* t = record.target;
+        if (t[X_AXIS] != x || t[Y_AXIS] != y || t[Z_AXIS] != z) {
+            x = t[X_AXIS];
+            y = t[Y_AXIS];
+            z = t[Z_AXIS];
+            steps.push_back({ false, record.pl_data.motion.rapidMotion != 0, x, y, z, 0 });
+        }
+    }
+    return steps;
+}
+
+// A drilling cycle as LinuxCNC describes it, in machine coordinates
+struct Cycle {
+    int                                  g;         // 73, 81, 82 or 83
+    bool                                 old_z;     // G98 rather than G99
+    float                                x, y, z;   // Start position
+    float                                r, depth;  // R plane and hole bottom
+    float                                q;         // Peck increment, for G73 and G83
+    float                                p;         // Dwell seconds, for G82
+    std::vector<std::pair<float, float>> holes;
+};
+
+static std::vector<Step> expand(const Cycle& c) {
+    const float       clearance = 0.254;
+    std::vector<Step> steps;
+    float             x = c.x, y = c.y, z = c.z;
+    auto              move = [&](bool rapid, float nx, float ny, float nz) {
+        if (nx != x || ny != y || nz != z) {
+            x = nx;
+            y = ny;
+            z = nz;
+            steps.push_back({ false, rapid, x, y, z, 0 });
+        }
+    };
+    float clear = c.old_z ? std::max(c.z, c.r) : c.r;
+    if (z < c.r) {
+        move(true, x, y, c.r);  // Preliminary move up to the R plane
+    }
+    for (auto& hole : c.holes) {
+        move(true, hole.first, hole.second, z);
+        move(true, x, y, c.r);
+        if (c.g == 81 || c.g == 82) {
+            move(false, x, y, c.depth);
+        } else {
+            float bottom = c.r;
+            while (bottom > c.depth) {
+                if (c.g == 83 && bottom < c.r) {
+                    move(true, x, y, std::min(bottom + clearance, c.r));
+                }
+                bottom = std::max(bottom - c.q, c.depth);
+                move(false, x, y, bottom);
+                if (bottom > c.depth) {
+                    move(true, x, y, c.g == 83 ? c.r : std::min(bottom + clearance, c.r));
+                }
+            }
+        }
+        if (c.g == 82) {
+            steps.push_back({ true, false, 0, 0, 0, int32_t(c.p * 1000) });
+        }
+        move(true, x, y, clear);
+    }
+    return steps;
+}
+
+class CannedCycle : public ::testing::Test {
+protected:
+    void SetUp() override { host_grbl_init(); }
+
+    // Moves to x, y, z, runs the cycle block, and compares its motion with the reference
+    void check(const char* block, const Cycle& cycle) {
+        char start[80];
+        snprintf(start, sizeof(start), "G21 G90 G0 X%.3f Y%.3f Z%.3f", cycle.x, cycle.y, cycle.z);
+        ASSERT_EQ(Error::Ok, host_execute_line(start));
+        host_motion.clear();
+        ASSERT_EQ(Error::Ok, host_execute_line(block)) << block;
+        EXPECT_EQ(format(expand(cycle)), format(recorded(cycle.x, cycle.y, cycle.z))) << block;
+    }
+};
+
+TEST_F(CannedCycle, Drill) {
+    check("G98 G81 X5 Y6 Z-3 R2 F100", { 81, true, 0, 0, 10, 2, -3, 0, 0, { { 5, 6 } } });
+    check("G99 G81 X5 Y6 Z-3 R2 F100", { 81, false, 0, 0, 10, 2, -3, 0, 0, { { 5, 6 } } });
+}
+
+TEST_F(CannedCycle, StartsBelowTheRPlane) {
+    check("G98 G81 X5 Y6 Z-3 R2 F100", { 81, true, 0, 0, 1, 2, -3, 0, 0, { { 5, 6 } } });
+}
+
+TEST_F(CannedCycle, DrillDwell) {
+    check("G99 G82 X1 Y1 Z-2 R1 P0.5 F100", { 82, false, 0, 0, 5, 1, -2, 0, 0.5, { { 1, 1 } } });
+}
+
+TEST_F(CannedCycle, Peck) {
+    check("G98 G83 X2 Y3 Z-3 R2 Q1.5 F100", { 83, true, 0, 0, 10, 2, -3, 1.5, 0, { { 2, 3 } } });
+}
+
+TEST_F(CannedCycle, ChipBreak) {
+    check("G99 G73 X2 Y3 Z-3 R2 Q1.5 F100", { 73, false, 0, 0, 10, 2, -3, 1.5, 0, { { 2, 3 } } });
+}
+
+TEST_F(CannedCycle, IncrementalRepeats) {
+    // In G91, R is from the start Z, the depth is from R, and each repeat moves on by X and Y
+    ASSERT_EQ(Error::Ok, host_execute_line("G21 G90 G0 X0 Y0 Z10"));
+    host_motion.clear();
+    ASSERT_EQ(Error::Ok, host_execute_line("G91 G98 G81 X10 Y5 Z-4 R-8 L3 F100"));
+    Cycle cycle = { 81, true, 0, 0, 10, 2, -2, 0, 0, { { 10, 5 }, { 20, 10 }, { 30, 15 } } };
+    EXPECT_EQ(format(expand(cycle)), format(recorded(0, 0, 10)));
+}
+
+TEST_F(CannedCycle, StickyWordsCarryToTheNextHole) {
+    ASSERT_EQ(Error::Ok, host_execute_line("G21 G90 G0 X0 Y0 Z10"));
+    ASSERT_EQ(Error::Ok, host_execute_line("G99 G83 X2 Y3 Z-3 R2 Q1.5 F100"));
+    host_motion.clear();
+    ASSERT_EQ(Error::Ok, host_execute_line("X7"));
+    Cycle cycle = { 83, false, 2, 3, 2, 2, -3, 1.5, 0, { { 7, 3 } } };
+    EXPECT_EQ(format(expand(cycle)), format(recorded(2, 3, 2)));
+}
+
+TEST_F(CannedCycle, PeckByHand) {
+    // The reference itself, checked once against a hand expansion
+    Cycle cycle = { 83, true, 0, 0, 10, 2, -1, 1.5, 0, { { 2, 3 } } };
+    EXPECT_EQ("G0 X2 Y3 Z10\n"
+              "G0 X2 Y3 Z2\n"
+              "G1 X2 Y3 Z0.5\n"
+              "G0 X2 Y3 Z2\n"
+              "G0 X2 Y3 Z0.754\n"
+              "G1 X2 Y3 Z-1\n"
+              "G0 X2 Y3 Z10\n",
+              format(expand(cycle)));
+}
@@ -0,0 +1,128 @@
+/*
+  GCodeTest.cpp - Tests of the g-code parser in GCode.cpp
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <gtest/gtest.h>
+
+class GCode : public ::testing::Test {
+protected:
+    void SetUp() override { host_grbl_init(); }
+};
+
+// Runs a test file whose lines give their expected result in a comment, as
+// "(ok ...)" or "(error:N ...)". Realtime commands and ; comments are skipped.
+TEST_F(GCode, NumbersFile) {
+    auto lines = host_read_lines(GRBL_TEST_FILES "/numbers.nc");
+    ASSERT_FALSE(lines.empty());
+    int checked = 0;
+    for (auto& line : lines) {
+        if (line.empty() || line[0] == ';' || line[0] == '?') {
+            continue;
+        }
+        Error  result = host_execute_line(line.c_str());
+        size_t error  = line.find("(error:");
+        if (error != std::string::npos) {
+            EXPECT_EQ(atoi(line.c_str() + error + 7), int(result)) << line;
+            checked++;
+        } else if (line.find("(ok") != std::string::npos) {
+            EXPECT_EQ(Error::Ok, result) << line;
+            checked++;
+        }
+    }
+    EXPECT_GT(checked, 10);
+}
+
+TEST_F(GCode, LinearMove) {
+    ASSERT_EQ(Error::Ok, host_execute_line("G21 G90 G1 X10 Y-5 F600"));
+    ASSERT_EQ(1u, host_motion.size());
+    EXPECT_EQ(MotionRecord::Kind::Line, host_motion[0].kind);
+    EXPECT_EQ(10.0f, host_motion[0].target[X_AXIS]);
+    EXPECT_EQ(-5.0f, host_motion[0].target[Y_AXIS]);
+    EXPECT_EQ(600.0f, host_motion[0].pl_data.feed_rate);
+    EXPECT_FALSE(host_motion[0].pl_data.motion.rapidMotion);
+}
+
+TEST_F(GCode, ModalStateCarriesOver) {
+    ASSERT_EQ(Error::Ok, host_execute_line("G20 G91 G0 X1"));
+    ASSERT_EQ(Error::Ok, host_execute_line("X1"));
+    ASSERT_EQ(2u, host_motion.size());
+    EXPECT_FLOAT_EQ(25.4f, host_motion[0].target[X_AXIS]);
+    EXPECT_FLOAT_EQ(50.8f, host_motion[1].target[X_AXIS]);
+    EXPECT_TRUE(host_motion[1].pl_data.motion.rapidMotion);
+}
+
+TEST_F(GCode, WorkOffsets) {
+    ASSERT_EQ(Error::Ok, host_execute_line("G10 L2 P2 X5"));
+    ASSERT_EQ(Error::Ok, host_execute_line("G55 G0 X1"));
+    ASSERT_EQ(1u, host_motion.size());
+    EXPECT_EQ(6.0f, host_motion[0].target[X_AXIS]);
+    EXPECT_GT(host_wco_changes, 0u);
+}
+
+TEST_F(GCode, Arc) {
+    ASSERT_EQ(Error::Ok, host_execute_line("G17 G2 X10 Y0 I5 J0 F100"));
+    ASSERT_EQ(1u, host_motion.size());
+    EXPECT_EQ(MotionRecord::Kind::Arc, host_motion[0].kind);
+    EXPECT_FLOAT_EQ(5.0f, host_motion[0].radius);
+    EXPECT_TRUE(host_motion[0].is_clockwise_arc);
+}
+
+TEST_F(GCode, ErrorsLeaveNoMotion) {
+    EXPECT_EQ(Error::GcodeUndefinedFeedRate, host_execute_line("G1 X10"));
+    EXPECT_EQ(Error::GcodeUnsupportedCommand, host_execute_line("G7 X1"));
+    EXPECT_EQ(Error::BadNumberFormat, host_execute_line("G0 X"));
+    EXPECT_TRUE(host_motion.empty());
+}
+
+TEST_F(GCode, StatusReply) {
+    EXPECT_EQ(Error::Ok, host_execute_line("$G"));
+    EXPECT_NE(std::string::npos, host_output[CLIENT_SERIAL].find("[GC:G0 G54 G17 G21 G90 G94"));
+}
+
+// A definition records only the lines of the client that opened it
+TEST_F(GCode, SubroutineBelongsToItsClient) {
+    ASSERT_EQ(Error::Ok, host_execute_line("G21 G90 F600"));
+    ASSERT_EQ(Error::Ok, host_execute_line("O100 SUB"));
+    ASSERT_EQ(Error::Ok, host_execute_line("G1 X5"));
+    EXPECT_TRUE(host_motion.empty());
+    ASSERT_EQ(Error::Ok, host_execute_line("G1 Y7", CLIENT_TELNET));
+    ASSERT_EQ(1u, host_motion.size());  // Run at once, not recorded
+    EXPECT_EQ(Error::GcodeSubroutineMismatch, host_execute_line("O100 ENDSUB", CLIENT_TELNET));
+    ASSERT_EQ(Error::Ok, host_execute_line("O100 ENDSUB"));
+    ASSERT_EQ(Error::Ok, host_execute_line("O100 CALL", CLIENT_TELNET));
+    ASSERT_EQ(2u, host_motion.size());
+    EXPECT_EQ(5.0f, host_motion[1].target[X_AXIS]);
+    EXPECT_EQ(7.0f, host_motion[1].target[Y_AXIS]);
+}
+
+// A file that ends or is closed inside a definition leaves nothing recording
+TEST_F(GCode, UnterminatedSubroutineIsDropped) {
+    ASSERT_EQ(Error::Ok, host_execute_line("G21 G90 F600"));
+    ASSERT_EQ(Error::Ok, host_execute_line("O200 REPEAT[2]"));
+    ASSERT_EQ(Error::Ok, host_execute_line("G1 X5"));
+    EXPECT_EQ(Error::Ok, gc_close_subroutine(CLIENT_TELNET));
+    EXPECT_TRUE(gc_recording_subroutine());
+    EXPECT_EQ(Error::GcodeSubroutineMismatch, gc_close_subroutine(CLIENT_SERIAL));
+    EXPECT_FALSE(gc_recording_subroutine());
+    EXPECT_EQ(Error::Ok, gc_close_subroutine(CLIENT_SERIAL));
+    ASSERT_EQ(Error::Ok, host_execute_line("G1 X3"));
+    ASSERT_EQ(1u, host_motion.size());
+    EXPECT_EQ(3.0f, host_motion[0].target[X_AXIS]);
+    EXPECT_EQ(Error::GcodeUndefinedSubroutine, host_execute_line("O200 CALL"));
+}
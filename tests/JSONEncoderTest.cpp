@@ -0,0 +1,201 @@
+/*
+  JSONEncoderTest.cpp - Tests of WebUI/JSONEncoder.cpp
+  Part of Grbl_ESP32
+
+  The encoder streams through a fixed buffer or collects a String. Both must
+  give the bytes the String-only encoder gave before streaming was added,
+  which is kept here as Reference::JSONencoder.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <gtest/gtest.h>
+
+namespace Reference {
+    // The String-only encoder as it was, reduced to what the tests call
+    class JSONencoder {
+    public:
+        JSONencoder(bool pretty) : pretty(pretty), level(0) { count[level] = 0; }
+
+        void   begin() { begin_object(); }
+        String end() {
+            end_object();
+            return str;
+        }
+        void member(const char* tag, const char* value) {
+            begin_member(tag);
+            quoted(value);
+        }
+        void member(const char* tag, int value) { member(tag, String(value).c_str()); }
+        void begin_array(const char* tag) {
+            begin_member(tag);
+            str += '[';
+            inc_level();
+            line();
+        }
+        void end_array() {
+            --level;
+            line();
+            str += ']';
+        }
+        void begin_object() {
+            comma_line();
+            str += '{';
+            inc_level();
+        }
+        void end_object() {
+            --level;
+            if (count[level + 1] > 1) {
+                line();
+            }
+            str += '}';
+        }
+        void begin_member(const char* tag) {
+            comma_line();
+            quoted(tag);
+            str += ':';
+        }
+        void begin_webui(const char* p, const char* help, const char* type, const char* val) {
+            begin_object();
+            member("F", "network");
+            member("P", p);
+            member("H", help);
+            member("T", type);
+            member("V", val);
+        }
+        void begin_webui(const char* p, const char* help, const char* type, const char* val, int min, int max) {
+            begin_webui(p, help, type, val);
+            member("S", max);
+            member("M", min);
+        }
+
+    private:
+        static const int MAX_JSON_LEVEL = 16;
+
+        bool   pretty;
+        int    level;
+        String str;
+        int    count[MAX_JSON_LEVEL];
+
+        void comma_line() {
+            if (count[level]) {
+                str += ',';
+                line();
+            }
+            count[level]++;
+        }
+        void quoted(const char* s) {
+            str += '"';
+            str += s;
+            str += '"';
+        }
+        void inc_level() {
+            if (++level == MAX_JSON_LEVEL) {
+                --level;
+            }
+            count[level] = 0;
+        }
+        void line() {
+            if (pretty) {
+                str += '\n';
+                for (int i = 0; i < 2 * level; i++) {
+                    str += ' ';
+                }
+            }
+        }
+    };
+}
+
+// A settings list like ESP400 sends, long enough to fill the stream buffer many times
+template <typename Encoder>
+static void settings_list(Encoder& j, int entries) {
+    j.begin();
+    j.begin_array("EEPROM");
+    for (int i = 0; i < entries; i++) {
+        String name = String("Setting/") + String(i);
+        String help = String("Help text ") + String(i * 7919);
+        j.begin_webui(name.c_str(), help.c_str(), i % 3 ? "I" : "S", String(i * 13).c_str(), -i, i * 100);
+        if (i % 5 == 0) {
+            j.begin_array("O");
+            for (int k = 0; k < 3; k++) {
+                j.begin_object();
+                j.member(String(k).c_str(), k);
+                j.end_object();
+            }
+            j.end_array();
+        }
+        j.end_object();
+    }
+    j.end_array();
+    j.member("Last", "");
+}
+
+// Objects nested to the deepest level the encoder counts
+template <typename Encoder>
+static void deep(Encoder& j) {
+    j.begin();
+    for (int i = 0; i < 14; i++) {
+        j.begin_member("n");
+        j.begin_object();
+        j.member("i", i);
+    }
+    for (int i = 0; i < 14; i++) {
+        j.end_object();
+    }
+}
+
+class JSONEncoder : public ::testing::TestWithParam<bool> {
+protected:
+    void SetUp() override { host_output[CLIENT_SERIAL].clear(); }
+};
+
+TEST_P(JSONEncoder, StringMatchesReference) {
+    bool                   pretty = GetParam();
+    Reference::JSONencoder reference(pretty);
+    WebUI::JSONencoder     encoder(pretty);
+    settings_list(reference, 40);
+    settings_list(encoder, 40);
+    EXPECT_STREQ(reference.end().c_str(), encoder.end().c_str());
+}
+
+TEST_P(JSONEncoder, StreamMatchesReference) {
+    bool pretty = GetParam();
+    for (int entries : { 0, 1, 2, 3, 17, 40, 200 }) {  // From under one buffer to many, ending at different offsets
+        Reference::JSONencoder   reference(pretty);
+        WebUI::ESPResponseStream stream(CLIENT_SERIAL, true);
+        WebUI::JSONencoder       encoder(pretty, &stream);
+        host_output[CLIENT_SERIAL].clear();
+        settings_list(reference, entries);
+        settings_list(encoder, entries);
+        String expected = reference.end();
+        EXPECT_STREQ("", encoder.end().c_str());
+        EXPECT_EQ(std::string(expected.c_str()), host_output[CLIENT_SERIAL]) << entries << " entries";
+    }
+}
+
+TEST_P(JSONEncoder, DeepNestingMatchesReference) {
+    bool                     pretty = GetParam();
+    Reference::JSONencoder   reference(pretty);
+    WebUI::ESPResponseStream stream(CLIENT_SERIAL, true);
+    WebUI::JSONencoder       encoder(pretty, &stream);
+    deep(reference);
+    deep(encoder);
+    String expected = reference.end();
+    encoder.end();
+    EXPECT_EQ(std::string(expected.c_str()), host_output[CLIENT_SERIAL]);
+}
+
+INSTANTIATE_TEST_SUITE_P(PrettyAndCompact, JSONEncoder, ::testing::Bool());
@@ -0,0 +1,231 @@
+/*
+  NotificationsTest.cpp - Tests of WebUI/NotificationsService.cpp
+  Part of Grbl_ESP32
+
+  Messages go to a stand-in server that plays back a script of replies, in
+  place of the TLS connection to the real service.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <WiFi.h>
+#include <atomic>
+#include <deque>
+#include <gtest/gtest.h>
+#include <thread>
+
+using WebUI::notificationsservice;
+
+// The settings WebSettings.cpp would make
+namespace WebUI {
+    static enum_opt_t notificationOptions = {
+        { "NONE", 0 },
+        { "LINE", 3 },
+        { "PUSHOVER", 1 },
+        { "EMAIL", 2 },
+    };
+    EnumSetting*   notification_type;
+    StringSetting* notification_t1;
+    StringSetting* notification_t2;
+    StringSetting* notification_ts;
+}
+
+// A server that takes whatever is sent, and answers each read with the next line of its script
+class StandIn : public Client {
+public:
+    std::string             host;
+    uint16_t                port     = 0;
+    int                     refusals = 0;  // Connections to refuse before accepting one
+    int                     attempts = 0;
+    std::string             sent;
+    std::deque<std::string> replies;
+    std::atomic<int>        stops { 0 };  // Connections closed, for waiting on another task's send
+
+    void reset() {
+        host.clear();
+        port     = 0;
+        refusals = 0;
+        attempts = 0;
+        sent.clear();
+        replies.clear();
+        stops = 0;
+        _open = false;
+        _pending.clear();
+    }
+
+    int connect(const char* h, uint16_t p) override {
+        attempts++;
+        if (refusals > 0) {
+            refusals--;
+            return 0;
+        }
+        host  = h;
+        port  = p;
+        _open = true;
+        return 1;
+    }
+    uint8_t connected() override { return _open && !(replies.empty() && _pending.empty()); }
+    void    stop() override {
+        _open = false;
+        stops++;
+    }
+    size_t write(uint8_t c) override {
+        sent += char(c);
+        return 1;
+    }
+    int available() override { return _pending.size() + replies.size(); }
+    int read() override {
+        if (_pending.empty()) {
+            if (replies.empty()) {
+                return -1;
+            }
+            _pending = replies.front() + "\n";
+            replies.pop_front();
+        }
+        int c = uint8_t(_pending[0]);
+        _pending.erase(0, 1);
+        return c;
+    }
+    int peek() override { return _pending.empty() ? -1 : uint8_t(_pending[0]); }
+
+private:
+    bool        _open = false;
+    std::string _pending;
+};
+
+class Notifications : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        using namespace WebUI;
+        notification_ts   = new StringSetting("Notification Settings", WEBSET, WA, NULL, "Notification/TS", "", 0, 127, NULL);
+        notification_t2   = new StringSetting("Notification Token 2", WEBSET, WA, NULL, "Notification/T2", "", 0, 63, NULL);
+        notification_t1   = new StringSetting("Notification Token 1", WEBSET, WA, NULL, "Notification/T1", "", 0, 63, NULL);
+        notification_type = new EnumSetting("Notification type", WEBSET, WA, NULL, "Notification/Type", 0, &notificationOptions, NULL);
+        host_grbl_init();
+    }
+
+    void SetUp() override {
+        server.reset();
+        WiFi.mode(WIFI_STA);
+        notificationsservice.setClient(&server);
+    }
+    void TearDown() override {
+        notificationsservice.end();
+        notificationsservice.setClient(NULL);
+    }
+
+    // Sets the settings as $ commands would. They are trimmed in place, so they are copied first.
+    static void configure(std::string type, std::string t1, std::string t2, std::string ts = "") {
+        WebUI::notification_type->setStringValue(&type[0]);
+        WebUI::notification_t1->setStringValue(&t1[0]);
+        WebUI::notification_t2->setStringValue(&t2[0]);
+        WebUI::notification_ts->setStringValue(&ts[0]);
+    }
+
+    StandIn server;
+};
+
+TEST_F(Notifications, Pushover) {
+    configure("PUSHOVER", "user-key", "app-token");
+    ASSERT_TRUE(notificationsservice.begin());
+    EXPECT_STREQ("Pushover", notificationsservice.getTypeString());
+    server.replies = { "HTTP/1.1 200 OK", "", "{\"status\":1,\"request\":\"x\"}" };
+    EXPECT_TRUE(notificationsservice.sendMSG("Job", "Done"));
+    EXPECT_EQ("api.pushover.net", server.host);
+    EXPECT_EQ(443, server.port);
+    EXPECT_NE(std::string::npos, server.sent.find("POST /1/messages.json HTTP/1.1\r\n"));
+    EXPECT_NE(std::string::npos, server.sent.find("\r\n\r\nuser=user-key&token=app-token&title=Job&message=Done&device=")) << server.sent;
+}
+
+TEST_F(Notifications, PushoverRefused) {
+    configure("PUSHOVER", "user-key", "app-token");
+    ASSERT_TRUE(notificationsservice.begin());
+    server.replies = { "{\"status\":0}" };
+    EXPECT_FALSE(notificationsservice.sendMSG("Job", "Done"));
+}
+
+TEST_F(Notifications, Email) {
+    configure("EMAIL", "me", "secret", "me@example.com#smtp.example.com:465");
+    ASSERT_TRUE(notificationsservice.begin());
+    server.replies = { "220 ready", "250 hello", "334 user", "334 pass", "235 ok", "250 from", "250 to", "354 go", "250 queued", "221 bye" };
+    EXPECT_TRUE(notificationsservice.sendMSG("Job", "Done"));
+    EXPECT_EQ("smtp.example.com", server.host);
+    EXPECT_EQ(465, server.port);
+    EXPECT_EQ("HELO friend\r\n"
+              "AUTH LOGIN\r\n"
+              "bWU=\r\n"
+              "c2VjcmV0\r\n"
+              "MAIL FROM: <me@example.com>\r\n"
+              "RCPT TO: <me@example.com>\r\n"
+              "DATA\r\n"
+              "From:ESP3D<me@example.com>\r\n"
+              "To: <me@example.com>\r\n"
+              "Subject: Job\r\n\r\n"
+              "Done\r\n"
+              ".\r\n"
+              "QUIT\r\n",
+              server.sent);
+}
+
+TEST_F(Notifications, NotStartedWithoutStation) {
+    configure("LINE", "token", "");
+    WiFi.mode(WIFI_AP);
+    EXPECT_FALSE(notificationsservice.begin());
+    EXPECT_FALSE(notificationsservice.started());
+    EXPECT_FALSE(notificationsservice.sendMSG("Job", "Done"));
+    EXPECT_EQ(0, server.attempts);
+}
+
+TEST_F(Notifications, QueuedMessageIsRetried) {
+    configure("LINE", "token", "");
+    ASSERT_TRUE(notificationsservice.begin());
+    server.refusals = 1;  // The first attempt fails; the retry comes after NOTIFICATION_BACKOFF
+    server.replies  = { "{\"status\":200}" };
+    ASSERT_TRUE(notificationsservice.queueMSG("Job", "Done"));
+    for (int i = 0; i < 500 && server.stops == 0; i++) {
+        delay(10);
+    }
+    EXPECT_EQ(2, server.attempts);
+    EXPECT_EQ("notify-api.line.me", server.host);
+    EXPECT_NE(std::string::npos, server.sent.find("Authorization: Bearer token\r\n"));
+    EXPECT_NE(std::string::npos, server.sent.find("\r\n\r\nmessage=Done"));
+}
+
+// begin() and end() from one task while another sends. Each send sees either a whole
+// configuration or none, never one begin() or end() is halfway through changing.
+TEST_F(Notifications, ReconfigureWhileSending) {
+    configure("PUSHOVER", "user-key", "app-token");
+    ASSERT_TRUE(notificationsservice.begin());
+    std::atomic<bool> done(false);
+    std::thread       other([&] {
+        while (!done) {
+            notificationsservice.begin();
+            notificationsservice.end();
+        }
+    });
+    int sent = 0;
+    for (int i = 0; i < 2000; i++) {
+        server.sent.clear();
+        server.replies = { "{\"status\":1}" };
+        if (notificationsservice.sendMSG("Job", "Done")) {
+            sent++;
+            EXPECT_NE(std::string::npos, server.sent.find("user=user-key&token=app-token&")) << server.sent;
+        }
+    }
+    done = true;
+    other.join();
+    SUCCEED() << sent << " of 2000 sent";
+}
@@ -0,0 +1,102 @@
+/*
+  NutsBoltsTest.cpp - Tests of the number parsing in NutsBolts.cpp
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <gtest/gtest.h>
+
+// Parses text from its start, and returns whether it parsed and how many characters it used
+static bool parse(const char* text, float* value, uint8_t* used = nullptr) {
+    uint8_t char_counter = 0;
+    bool    ok           = read_float(text, &char_counter, value);
+    if (used) {
+        *used = char_counter;
+    }
+    return ok;
+}
+
+TEST(ReadFloat, PlainNumbers) {
+    float value;
+    ASSERT_TRUE(parse("123", &value));
+    EXPECT_EQ(123.0f, value);
+    ASSERT_TRUE(parse("-1.5", &value));
+    EXPECT_EQ(-1.5f, value);
+    ASSERT_TRUE(parse("+.5", &value));
+    EXPECT_EQ(0.5f, value);
+    ASSERT_TRUE(parse("7.", &value));
+    EXPECT_EQ(7.0f, value);
+    ASSERT_TRUE(parse("0.0001", &value));
+    EXPECT_FLOAT_EQ(0.0001f, value);
+}
+
+TEST(ReadFloat, StopsAfterTheNumber) {
+    float   value;
+    uint8_t used;
+    ASSERT_TRUE(parse("12.5X3", &value, &used));
+    EXPECT_EQ(12.5f, value);
+    EXPECT_EQ(4, used);
+    ASSERT_TRUE(parse("1.2.3", &value, &used));  // A second point ends the number
+    EXPECT_EQ(1.2f, value);
+    EXPECT_EQ(3, used);
+}
+
+TEST(ReadFloat, NeedsADigit) {
+    float value = 42.0f;
+    EXPECT_FALSE(parse("", &value));
+    EXPECT_FALSE(parse(".", &value));
+    EXPECT_FALSE(parse("-", &value));
+    EXPECT_FALSE(parse("+X", &value));
+    EXPECT_EQ(42.0f, value);  // Left alone on failure
+}
+
+TEST(ReadFloat, LeadingZerosKeepPrecision) {
+    float value;
+    ASSERT_TRUE(parse("000000000123", &value));
+    EXPECT_EQ(123.0f, value);
+    ASSERT_TRUE(parse("0.00000000000000000001", &value));
+    EXPECT_FLOAT_EQ(1e-20f, value);
+    ASSERT_TRUE(parse("-0", &value));
+    EXPECT_EQ(0.0f, value);
+}
+
+TEST(ReadFloat, LongNumbersDropDigitsNotMagnitude) {
+    float value;
+    ASSERT_TRUE(parse("12345678901234567890", &value));
+    EXPECT_FLOAT_EQ(1.2345678e19f, value);
+    ASSERT_TRUE(parse("1.23456789012345678901234567890", &value));
+    EXPECT_FLOAT_EQ(1.2345678f, value);
+}
+
+TEST(ReadFloat, OverflowIsAnError) {
+    float value = 42.0f;
+    EXPECT_FALSE(parse("1000000000000000000000000000000000000000", &value));
+    EXPECT_FALSE(parse("-1000000000000000000000000000000000000000", &value));
+    EXPECT_EQ(42.0f, value);
+    ASSERT_TRUE(parse("100000000000000000000000000000000000000", &value));  // 1e38 still fits
+    EXPECT_TRUE(isfinite(value));
+}
+
+TEST(ReadFloat, LongestLineOfZeros) {
+    // A 255 character line must not wrap the decimal exponent around
+    std::string text = "0." + std::string(250, '0') + "1";
+    float       value;
+    ASSERT_TRUE(parse(text.c_str(), &value));
+    EXPECT_EQ(0.0f, value);
+    text = std::string(250, '9');
+    EXPECT_FALSE(parse(text.c_str(), &value));
+}
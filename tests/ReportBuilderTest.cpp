@@ -0,0 +1,161 @@
+/*
+  ReportBuilderTest.cpp - Tests of ReportBuilder.cpp and the status report built with it
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+// A job on the card, whose name the status report carries, replacing the stubs in GrblStubs.cpp
+static std::string sd_job_name;
+
+SDState get_sd_state(bool refresh) {
+    return sd_job_name.empty() ? SDState::Idle : SDState::BusyPrinting;
+}
+float sd_report_perc_complete() {
+    return 12.5;
+}
+void sd_get_current_filename(char* name) {
+    strcpy(name, sd_job_name.c_str());
+}
+
+static std::string fixed(float value, uint8_t decimals) {
+    char          buf[32];
+    ReportBuilder rpt(buf, sizeof(buf));
+    rpt.append_fixed(value, decimals);
+    return rpt.c_str();
+}
+
+static std::string printf_fixed(float value, uint8_t decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    return buf;
+}
+
+TEST(ReportBuilder, Integers) {
+    char          buf[64];
+    ReportBuilder rpt(buf, sizeof(buf));
+    rpt.append_int(0);
+    rpt.append(',');
+    rpt.append_int(-42);
+    rpt.append(',');
+    rpt.append_int(INT32_MIN);
+    rpt.append(',');
+    rpt.append_uint(UINT32_MAX);
+    EXPECT_STREQ("0,-42,-2147483648,4294967295", rpt.c_str());
+    EXPECT_EQ(strlen(buf), rpt.length());
+}
+
+TEST(ReportBuilder, FixedMatchesPrintf) {
+    const float values[] = { 0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 1.5f, 2.5f, 0.0005f, -0.0004f, 0.125f, 0.0625f, 1e-6f, -1e-6f,
+                             1e-40f, 123.456f, -99.999f, 1e5f, 12345.678f, 2.1e5f, 1.9999e9f, 2.1e9f, -3e10f, INFINITY, -INFINITY, NAN };
+    for (float value : values) {
+        for (uint8_t decimals = 0; decimals <= 5; decimals++) {
+            EXPECT_EQ(printf_fixed(value, decimals), fixed(value, decimals)) << value << " with " << int(decimals) << " decimals";
+        }
+    }
+}
+
+TEST(ReportBuilder, FixedMatchesPrintfOnRandomFloats) {
+    std::mt19937                          rng(1);
+    std::uniform_real_distribution<float> mm(-2000.0f, 2000.0f);
+    std::uniform_int_distribution<int>    decimals(0, 4);
+    for (int i = 0; i < 200000; i++) {
+        float   value = i & 1 ? mm(rng) : std::round(mm(rng) * 1000.0f) / 1000.0f + 0.0005f;  // Also near the halfway points
+        uint8_t d     = decimals(rng);
+        ASSERT_EQ(printf_fixed(value, d), fixed(value, d)) << value << " with " << int(d) << " decimals";
+    }
+}
+
+TEST(ReportBuilder, DropsWhatDoesNotFit) {
+    char          buf[8];
+    ReportBuilder rpt(buf, sizeof(buf));
+    rpt.append("1234");
+    EXPECT_FALSE(rpt.overflowed());
+    rpt.append("5678");
+    EXPECT_TRUE(rpt.overflowed());
+    EXPECT_STREQ("1234567", rpt.c_str());
+    rpt.truncate(4);
+    EXPECT_FALSE(rpt.overflowed());
+    EXPECT_STREQ("1234", rpt.c_str());
+}
+
+TEST(ReportBuilder, ReservedTailStillFits) {
+    char          buf[8];
+    ReportBuilder rpt(buf, sizeof(buf));
+    rpt.reserve(3);
+    rpt.append("<12345");
+    EXPECT_TRUE(rpt.overflowed());
+    EXPECT_STREQ("<123", rpt.c_str());
+    rpt.release();
+    rpt.append(">\r\n");
+    EXPECT_STREQ("<123>\r\n", rpt.c_str());
+}
+
+class StatusReport : public ::testing::Test {
+protected:
+    void SetUp() override {
+        host_grbl_init();
+        sd_job_name.clear();
+        host_output[CLIENT_SERIAL].clear();
+    }
+    void TearDown() override { sd_job_name.clear(); }
+
+    std::string report() {
+        host_output[CLIENT_SERIAL].clear();
+        report_realtime_status(CLIENT_SERIAL);
+        return host_output[CLIENT_SERIAL];
+    }
+};
+
+TEST_F(StatusReport, CarriesTheJobName) {
+    sd_job_name     = "/job.nc";
+    std::string out = report();
+    EXPECT_NE(std::string::npos, out.find("|SD:12.50,/job.nc>\r\n")) << out;
+}
+
+TEST_F(StatusReport, DropsAFieldThatDoesNotFitAndStillCloses) {
+    for (int axis = 0; axis < MAX_N_AXIS; axis++) {
+        sys_position[axis] = -2000000000;  // Long position numbers leave too little room for the name
+    }
+    sd_job_name     = "/" + std::string(126, 'x');
+    std::string out = report();
+    ASSERT_GE(out.size(), 3u);
+    EXPECT_EQ('<', out.front());
+    EXPECT_EQ(">\r\n", out.substr(out.size() - 3)) << out;
+    EXPECT_EQ(std::string::npos, out.find("|SD:")) << out;
+    EXPECT_LT(out.size(), 200u);
+}
+
+// Formatted output longer than the stack buffer in grbl_sendf() is sent whole, as it
+// was before that buffer, and a fragment the caller ends itself gets no line ending
+TEST(SendF, LongOutputIsSentWhole) {
+    std::string value(3 * 256, 'x');
+    host_output[CLIENT_SERIAL].clear();
+    grbl_sendf(CLIENT_SERIAL, "$N0=%s\r\n", value.c_str());
+    EXPECT_EQ("$N0=" + value + "\r\n", host_output[CLIENT_SERIAL]);
+
+    host_output[CLIENT_SERIAL].clear();
+    grbl_sendf(CLIENT_SERIAL, "$Name=%s", value.c_str());
+    grbl_sendf(CLIENT_SERIAL, "\r\n");
+    EXPECT_EQ("$Name=" + value + "\r\n", host_output[CLIENT_SERIAL]);
+
+    host_output[CLIENT_SERIAL].clear();
+    grbl_msg_sendf(CLIENT_SERIAL, MsgLevel::Info, "%s", value.c_str());
+    EXPECT_EQ("[MSG:" + value + "]\r\n", host_output[CLIENT_SERIAL]);
+}
@@ -0,0 +1,451 @@
+/*
+  SDCardTest.cpp - Tests of reading SD jobs in SDCard.cpp
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <SD.h>
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+class SDReader : public ::testing::Test {
+protected:
+    void SetUp() override {
+        host_grbl_init();
+        SD_client         = CLIENT_SERIAL;
+        SD.volume().reads = 0;
+    }
+    void TearDown() override { closeFile(); }
+
+    // Lines of varied length, some empty, crossing the read buffers at different offsets
+    static std::string text(size_t len) {
+        std::string text;
+        for (size_t i = 0; text.size() < len; i++) {
+            text += std::string(i * 37 % 101, 'A' + i % 26) + "\n";
+        }
+        text.resize(len);
+        return text;
+    }
+
+    // A job of count moves
+    static std::string gcode(int count) {
+        std::string data = "G21 G90 F1200\n";
+        for (int i = 0; i < count; i++) {
+            data += "G1 X" + std::to_string(i % 97) + " Y" + std::to_string(i * 13 % 89) + "\n";
+        }
+        return data;
+    }
+
+    // The lines readFileLine() should return: split at each newline. An empty line at the
+    // very end is not returned, which makes no difference as empty lines do nothing.
+    static std::vector<std::string> split(const std::string& text) {
+        std::vector<std::string> lines;
+        size_t                   start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('\n', start);
+            end        = end == std::string::npos ? text.size() : end;
+            lines.push_back(text.substr(start, end - start));
+            start = end + 1;
+        }
+        if (!lines.empty() && lines.back().empty()) {
+            lines.pop_back();
+        }
+        return lines;
+    }
+
+    static std::vector<std::string> read_lines() {
+        std::vector<std::string> lines;
+        char                     line[LINE_BUFFER_SIZE];
+        while (readFileLine(line, LINE_BUFFER_SIZE - 1)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    static std::string gzip(const std::string& data) {
+        z_stream stream = {};
+        deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+        std::string out(deflateBound(&stream, data.size()) + 32, '\0');
+        stream.next_in   = (Bytef*)data.data();
+        stream.avail_in  = data.size();
+        stream.next_out  = (Bytef*)&out[0];
+        stream.avail_out = out.size();
+        deflate(&stream, Z_FINISH);
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+        return out;
+    }
+};
+
+TEST_F(SDReader, LinesMatchAcrossBuffers) {
+    const size_t B = SD_READ_BUFFER_SIZE;
+    for (size_t len : { size_t(0), size_t(1), B - 1, B, B + 1, 3 * B + 17, 10 * B }) {
+        std::string data = text(len);
+        SD.put("/job.nc", data);
+        SD.volume().reads = 0;
+        ASSERT_TRUE(openFile(SD, "/job.nc"));
+        EXPECT_EQ(split(data), read_lines()) << len << " bytes";
+        closeFile();
+        EXPECT_LE(SD.volume().reads, len / B + 3) << len << " bytes";  // Whole buffers, and the reads that find the end
+    }
+}
+
+TEST_F(SDReader, LongLineEndsTheRead) {
+    SD.put("/job.nc", "G0 X1\n" + std::string(LINE_BUFFER_SIZE, 'X') + "\nG0 X2\n");
+    ASSERT_TRUE(openFile(SD, "/job.nc"));
+    EXPECT_EQ(std::vector<std::string> { "G0 X1" }, read_lines());
+}
+
+// A directory listing is kept while it is paged through. Without PSRAM its memory is given
+// back with the last page, and any change to the card makes it stale.
+TEST_F(SDReader, ListingIsKeptUntilItsLastPage) {
+    SD.mkdir("/list");
+    for (int i = 0; i < 5; i++) {
+        SD.put(("/list/" + std::to_string(i) + ".nc").c_str(), "G0 X1\n");
+    }
+    std::vector<std::string> names;
+    auto each = [&](const char* name, bool directory, uint32_t size) { names.push_back(name); };
+    EXPECT_EQ(5u, listDirPage("/list", "", 0, 2, each));
+    EXPECT_TRUE(isDirCached("/list"));
+    EXPECT_EQ(5u, listDirPage("/list", "", 2, 2, each));
+    EXPECT_TRUE(isDirCached("/list"));
+    EXPECT_EQ(5u, listDirPage("/list", "", 4, 2, each));
+    EXPECT_FALSE(isDirCached("/list"));
+    EXPECT_EQ(5u, names.size());
+
+    listDirPage("/list", "", 0, 2, each);
+    ASSERT_TRUE(isDirCached("/list"));
+    removeFile(SD, "/list/0.nc");
+    EXPECT_FALSE(isDirCached("/list"));
+}
+
+TEST_F(SDReader, CompressedMatchesPlain) {
+    std::string data = text(200000);  // Inflates through the window several times
+    SD.put("/job.nc.gz", gzip(data));
+    ASSERT_TRUE(openFile(SD, "/job.nc.gz"));
+    EXPECT_EQ(split(data), read_lines());
+}
+
+TEST_F(SDReader, TruncatedCompressedFileFails) {
+    std::string data = gzip(gcode(5000));
+    SD.put("/job.nc.gz", data.substr(0, data.size() / 2));
+    ASSERT_TRUE(openJobFile(SD, "/job.nc.gz"));
+    Error status = Error::Ok;
+    while (status == Error::Ok && executeFileLine(&status)) {}
+    EXPECT_EQ(Error::FsFailedRead, status);
+}
+
+// A job read from the card moves the machine as the same lines sent one at a time do
+TEST_F(SDReader, JobRunsLikeItsLines) {
+    std::string data = gcode(2000);
+    for (auto& line : split(data)) {
+        ASSERT_EQ(Error::Ok, host_execute_line(line.c_str()));
+    }
+    auto expected = host_motion;
+    host_grbl_init();
+
+    SD.put("/job.nc", data);
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+    Error status = Error::Ok;
+    while (executeFileLine(&status)) {
+        ASSERT_EQ(Error::Ok, status) << sd_get_current_line_number();
+    }
+    ASSERT_EQ(expected.size(), host_motion.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(host_format_motion(expected[i]), host_format_motion(host_motion[i])) << i;
+    }
+}
+
+// Restarting a job part way through, from its checkpoint index
+class SDRestart : public SDReader {
+protected:
+    // A job that changes modal state as it goes and calls a subroutine it defines near the start.
+    // Every hundred lines it drills a few holes, ending with the cycles active at each checkpoint.
+    static std::string job(int count) {
+        static const char* modes[] = { "G20", "G21", "G90", "G91", "G17", "G18", "G19", "G55", "G54", "G56", "M3 S1000", "M3 S2500",
+                                       "M5",  "M7",  "M8",  "M9",  "T3",  "T7",  "F300", "F900", "G98", "G99", "G0 X3",    "O100 CALL" };
+        static const char* drills[] = { "G17 G99 G81 X1 Y1 Z-1 R2", "G17 G98 G83 X2 Y1 Z-3 R1 Q0.5" };
+        std::string         data     = "G21 G90 F1200\nO100 SUB\nG1 X1 Y2\nG1 X0\nO100 ENDSUB\n";
+        for (int i = 0; i < count; i++) {
+            std::string xy = "X" + std::to_string(i % 31) + " Y" + std::to_string(i * 13 % 29) + "\n";
+            if (i % 100 == 90) {
+                data += std::string(drills[i / 100 % 2]) + "\n";
+            } else if (i % 100 > 90) {
+                data += xy;  // Another hole, at the depths above
+            } else {
+                data += i % 7 == 3 ? std::string(modes[i * 13 % (sizeof(modes) / sizeof(*modes))]) + "\n" : "G1 " + xy;
+            }
+        }
+        return data;
+    }
+
+    // gc_state after running the first lines of data in check mode, one at a time. The
+    // parser is then reset, keeping the work offsets.
+    static parser_state_t replayed(const std::string& data, uint32_t lines) {
+        sys.state = State::CheckMode;
+        auto all  = split(data);
+        for (uint32_t i = 0; i < lines; i++) {
+            host_execute_line(all[i].c_str());
+        }
+        parser_state_t state = gc_state;
+        sys.state            = State::Idle;
+        gc_init();
+        return state;
+    }
+
+    static void expect_same_state(const parser_state_t& expected, uint32_t line) {
+        EXPECT_EQ(0, memcmp(&expected.modal, &gc_state.modal, sizeof(gc_modal_t))) << "line " << line;
+        EXPECT_EQ(expected.spindle_speed, gc_state.spindle_speed) << "line " << line;
+        EXPECT_EQ(expected.feed_rate, gc_state.feed_rate) << "line " << line;
+        EXPECT_EQ(expected.tool, gc_state.tool) << "line " << line;
+        EXPECT_EQ(0, memcmp(&expected.canned, &gc_state.canned, sizeof(gc_canned_t))) << "line " << line;
+        EXPECT_EQ(0, memcmp(expected.coord_system, gc_state.coord_system, sizeof(gc_state.coord_system))) << "line " << line;
+    }
+};
+
+TEST_F(SDRestart, RestoredStateMatchesFullReplay) {
+    std::string data = job(4 * SD_INDEX_INTERVAL);
+    SD.put("/job.nc", data);
+    SD.remove("/job.nc.gci");
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));  // Builds the index
+    Error status = Error::Ok;
+    while (executeFileLine(&status)) {
+        ASSERT_EQ(Error::Ok, status) << sd_get_current_line_number();
+    }
+    closeFile();
+    ASSERT_TRUE(SD.exists("/job.nc.gci"));
+
+    for (uint32_t line : { 2u, 999u, 1000u, 1001u, 1002u, 2500u, 3999u, 4003u }) {
+        host_grbl_init();
+        ASSERT_EQ(Error::Ok, host_execute_line("G10 L2 P2 X7 Y-3"));  // Work offsets changed since the index was written
+        parser_state_t expected = replayed(data, line - 1);
+        ASSERT_EQ(Error::Ok, host_execute_line("G17 G90 G81 X0 Y0 Z-20 R5 F100"));  // A cycle run by hand leaves its depths behind
+        ASSERT_EQ(Error::Ok, host_execute_line("G80"));
+        ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+        ASSERT_TRUE(seekFileLine(line));
+        EXPECT_EQ(line - 1, sd_get_current_line_number());
+        expect_same_state(expected, line);
+        closeFile();
+    }
+}
+
+TEST_F(SDRestart, RestartSkipsMostOfTheFile) {
+    std::string data = job(20 * SD_INDEX_INTERVAL);
+    SD.put("/job.nc", data);
+    SD.remove("/job.nc.gci");
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+    uint32_t opening = SD.volume().reads;  // Hashing the file for its index
+    ASSERT_TRUE(seekFileLine(20 * SD_INDEX_INTERVAL));  // Replays every line, writing the index
+    closeFile();
+    uint32_t unindexed = SD.volume().reads - opening;
+
+    host_grbl_init();
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+    SD.volume().reads = 0;
+    ASSERT_TRUE(seekFileLine(20 * SD_INDEX_INTERVAL));
+    closeFile();
+    EXPECT_LT(SD.volume().reads * 3, unindexed);  // The last 1000 lines and the definitions at the start
+}
+
+// The rest of the job runs after a restart, calling a subroutine defined before the checkpoint,
+// in the work offsets as they are now
+TEST_F(SDRestart, RestartedJobRuns) {
+    std::string data = job(3 * SD_INDEX_INTERVAL);
+    SD.put("/job.nc", data);
+    SD.remove("/job.nc.gci");
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+    Error status = Error::Ok;
+    while (executeFileLine(&status)) {}
+    closeFile();
+
+    host_grbl_init();  // As after a reset, which forgets subroutines
+    ASSERT_EQ(Error::Ok, host_execute_line("G10 L2 P2 X7"));
+    host_wco_changes = 0;
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+    ASSERT_TRUE(seekFileLine(2 * SD_INDEX_INTERVAL + 10));
+    EXPECT_GT(host_wco_changes, 0u);
+    host_motion.clear();  // Motion control drops the moves replayed in check mode
+    while (executeFileLine(&status)) {
+        ASSERT_EQ(Error::Ok, status) << sd_get_current_line_number();
+    }
+    EXPECT_FALSE(host_motion.empty());
+}
+
+// An edit that leaves the size and time of the file unchanged starts a new index
+TEST_F(SDRestart, IndexFollowsTheContents) {
+    std::string first  = job(2 * SD_INDEX_INTERVAL);
+    std::string second = first;
+    second[second.rfind("X1 ") + 1] = '2';  // After the last checkpoint, so only the hash tells
+    SD.put("/job.nc", first);
+    SD.remove("/job.nc.gci");
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+    ASSERT_TRUE(seekFileLine(2 * SD_INDEX_INTERVAL));
+    closeFile();
+    std::string index = SD.get("/job.nc.gci");
+
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+    closeFile();
+    EXPECT_EQ(index, SD.get("/job.nc.gci")) << "kept while the file is unchanged";
+
+    SD.put("/job.nc", second);  // Rewritten without the clock moving
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+    closeFile();
+    EXPECT_LT(SD.get("/job.nc.gci").size(), index.size());
+}
+
+// [ESP220] only sets the restart line; the protocol loop restarts the job with restartFile(),
+// which leaves the machine state as it found it
+TEST_F(SDRestart, RestartFileKeepsTheMachineState) {
+    std::string data = job(2 * SD_INDEX_INTERVAL);
+    SD.put("/job.nc", data);
+    SD.remove("/job.nc.gci");
+    host_grbl_init();
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+    SD_restart_line = SD_INDEX_INTERVAL + 5;
+    ASSERT_TRUE(restartFile());
+    EXPECT_EQ(0u, SD_restart_line);
+    EXPECT_EQ(uint32_t(SD_INDEX_INTERVAL + 4), sd_get_current_line_number());
+    EXPECT_EQ(State::Idle, State(sys.state));
+    EXPECT_EQ(gc_state.modal.spindle, spindle->get_state());
+    EXPECT_EQ(gc_state.modal.coolant.Flood, coolant_get_state().Flood);
+    EXPECT_EQ(gc_state.modal.coolant.Mist, coolant_get_state().Mist);
+    closeFile();
+
+    ASSERT_TRUE(openJobFile(SD, "/job.nc"));
+    SD_restart_line = 3 * SD_INDEX_INTERVAL;
+    EXPECT_FALSE(restartFile());  // Past the end
+    EXPECT_EQ(State::Idle, State(sys.state));
+    closeFile();
+}
+
+// Jobs compiled with $SD/Compile
+class SDCompile : public SDReader {
+protected:
+    // The moves a job makes when run from the card
+    static std::vector<std::string> run(const char* path) {
+        host_grbl_init();
+        std::vector<std::string> moves;
+        Error                    status = Error::Ok;
+        if (!openJobFile(SD, path)) {
+            return moves;
+        }
+        while (executeFileLine(&status)) {
+            EXPECT_EQ(Error::Ok, status) << sd_get_current_line_number();
+        }
+        closeFile();
+        for (auto& record : host_motion) {
+            moves.push_back(host_format_motion(record));
+        }
+        return moves;
+    }
+};
+
+TEST_F(SDCompile, CompiledJobRunsLikeItsSource) {
+    std::string data = "(A comment, kept as text)\n" + gcode(3000) + "G0 X0";  // No newline at the end
+    SD.put("/job.nc", data);
+    SD.remove("/job.nc.gcb");
+    auto expected = run("/job.nc");
+
+    SD.volume().reads = 0;
+    ASSERT_EQ(Error::Ok, compileFile(SD, "/job.nc"));
+    EXPECT_LE(SD.volume().reads, data.size() / 512 + 2);  // Block reads, not a read per byte
+    std::string compiled = SD.get("/job.nc.gcb");
+    ASSERT_GE(compiled.size(), sizeof(sd_compiled_header_t));
+    sd_compiled_header_t header;
+    memcpy(&header, compiled.data(), sizeof(header));
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : data) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    EXPECT_EQ(SD_COMPILED_MAGIC, header.magic);
+    EXPECT_EQ(data.size(), header.source_size);
+    EXPECT_EQ(uint32_t(SD.volume().clock), header.source_mtime);
+    EXPECT_EQ(hash, header.source_hash);
+
+    EXPECT_EQ(expected, run("/job.nc"));
+}
+
+// A sidecar is left for the source as soon as the source changes, even when its size and
+// modification time do not
+// A line of SD_LINE_MAX characters runs, from the source or compiled, with or without a
+// newline after it. One character more stops the job, and the file does not compile.
+TEST_F(SDCompile, LongestLineIsTheSameCompiled) {
+    std::string longest = "G0 X1 (" + std::string(SD_LINE_MAX - 8, 'x') + ")";
+    ASSERT_EQ(size_t(SD_LINE_MAX), longest.size());
+    for (const std::string& data : { longest + "\nG0 X2\n", "G0 X2\n" + longest }) {
+        SD.put("/job.nc", data);
+        SD.remove("/job.nc.gcb");
+        auto expected = run("/job.nc");
+        EXPECT_EQ(2u, expected.size());
+        ASSERT_EQ(Error::Ok, compileFile(SD, "/job.nc"));
+        EXPECT_EQ(expected, run("/job.nc"));
+    }
+
+    std::string longer = "G0 X1 (" + std::string(SD_LINE_MAX - 7, 'x') + ")";
+    for (const std::string& data : { longer + "\nG0 X2\n", "G0 X2\n" + longer }) {
+        SD.put("/job.nc", data);
+        SD.remove("/job.nc.gcb");
+        ASSERT_TRUE(openFile(SD, "/job.nc"));
+        EXPECT_LT(read_lines().size(), 2u);
+        closeFile();
+        EXPECT_EQ(Error::Overflow, compileFile(SD, "/job.nc"));
+        EXPECT_FALSE(SD.exists("/job.nc.gcb"));
+    }
+}
+
+TEST_F(SDCompile, SidecarFollowsItsSource) {
+    std::string first  = gcode(500);
+    std::string second = first;
+
+    second[second.find("X1 ") + 1] = '2';  // Same size
+    SD.put("/second.nc", second);
+    auto expected = run("/second.nc");
+
+    SD.put("/job.nc", first);
+    ASSERT_EQ(Error::Ok, compileFile(SD, "/job.nc"));
+    auto compiled = run("/job.nc");
+    EXPECT_NE(compiled, expected);
+    SD.put("/job.nc", second);  // Rewritten without the clock moving, so its time is unchanged
+    EXPECT_EQ(expected, run("/job.nc"));
+
+    SD.put("/job.nc", first);  // Back as it was compiled, so the sidecar is used again
+    SD.remove("/job.nc.gcb.gci");
+    EXPECT_EQ(compiled, run("/job.nc"));
+    EXPECT_TRUE(SD.exists("/job.nc.gcb.gci"));  // The restart index of the job that ran
+
+    SD.volume().clock++;
+    SD.put("/job.nc", second);
+    EXPECT_EQ(expected, run("/job.nc"));
+
+    SD.put("/job.nc", second + "G0 X0\n");  // Grown
+    EXPECT_EQ(expected.size() + 1, run("/job.nc").size());
+}
+
+// Deleting a file deletes what was made from it, which a new file of that name could pick up
+TEST_F(SDCompile, RemovingTheSourceRemovesItsSidecars) {
+    SD.put("/job.nc", gcode(100));
+    SD.put("/job.nc.gci", "stale");
+    ASSERT_EQ(Error::Ok, compileFile(SD, "/job.nc"));
+    run("/job.nc");  // Writes /job.nc.gcb.gci
+    ASSERT_TRUE(SD.exists("/job.nc.gcb") && SD.exists("/job.nc.gcb.gci"));
+
+    EXPECT_TRUE(removeFile(SD, "/job.nc"));
+    for (const char* path : { "/job.nc", "/job.nc.gcb", "/job.nc.gci", "/job.nc.gcb.gci" }) {
+        EXPECT_FALSE(SD.exists(path)) << path;
+    }
+    EXPECT_FALSE(removeFile(SD, "/job.nc"));
+}
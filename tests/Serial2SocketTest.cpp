@@ -0,0 +1,188 @@
+/*
+  Serial2SocketTest.cpp - Tests of WebUI/Serial2Socket.cpp and the frames it broadcasts
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+#include "Sockets.h"
+#include "WebUI/Serial2Socket.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+using WebUI::Serial2Socket;
+
+static const int CLIENTS = 3;
+
+// Output lines, generated from their length
+static std::string lines(size_t len) {
+    std::string text;
+    for (size_t i = 0; text.size() < len; i++) {
+        text += "<Run|MPos:" + std::to_string(i) + ".000,0.000,0.000|FS:500,0>\r\n";
+    }
+    text.resize(len);
+    return text;
+}
+
+class Broadcast : public ::testing::Test {
+protected:
+    // The test is the web server task, so flush() sends at once
+    void SetUp() override {
+        server.reset(new HostSocketServer(CLIENTS));
+        Serial2Socket.attachWS(server.get(), xTaskGetCurrentTaskHandle());
+    }
+    void TearDown() override { Serial2Socket.detachWS(); }
+
+    std::unique_ptr<HostSocketServer> server;
+};
+
+TEST_F(Broadcast, ReportIsOneFrameWithoutAllocating) {
+    std::string text = "<Idle|MPos:0.000,0.000,0.000|FS:0,0>\r\nok\r\n";
+
+    size_t before = host_allocations;
+    Serial2Socket.write(text.c_str());
+    Serial2Socket.flush();
+    EXPECT_EQ(host_allocations - before, 0u);
+
+    for (int i = 0; i < CLIENTS; i++) {
+        EXPECT_EQ(host_socket_frames(server->client(i)), std::vector<std::string> { text }) << "client " << i;
+        EXPECT_EQ(server->client(i).writes, 1u) << "header and data go out together";
+    }
+}
+
+TEST_F(Broadcast, LongOutputIsSentInFullBuffers) {
+    std::string text = lines(3000);
+
+    size_t before = host_allocations;
+    Serial2Socket.write((const uint8_t*)text.data(), text.size());
+    Serial2Socket.flush();
+    EXPECT_EQ(host_allocations - before, 0u);
+
+    for (int i = 0; i < CLIENTS; i++) {
+        auto frames = host_socket_frames(server->client(i));
+        ASSERT_EQ(frames.size(), 3u) << "client " << i;
+        EXPECT_EQ(frames[0].size(), frames[1].size());
+        EXPECT_EQ(frames[0] + frames[1] + frames[2], text);
+        EXPECT_EQ(server->client(i).writes, frames.size());
+    }
+}
+
+// Callers without room for the header in front of their data
+TEST_F(Broadcast, ShortFrameIsPackedOnTheStack) {
+    std::string text = lines(100);
+
+    size_t before = host_allocations;
+    server->broadcastBIN((const uint8_t*)text.data(), text.size());
+    EXPECT_EQ(host_allocations - before, 0u);
+
+    for (int i = 0; i < CLIENTS; i++) {
+        EXPECT_EQ(host_socket_frames(server->client(i)), std::vector<std::string> { text });
+        EXPECT_EQ(server->client(i).writes, 1u);
+    }
+}
+
+TEST_F(Broadcast, LongFrameIsCopiedForEachClient) {
+    std::string text = lines(1000);
+
+    size_t before = host_allocations;
+    server->broadcastBIN((const uint8_t*)text.data(), text.size());
+    EXPECT_EQ(host_allocations - before, size_t(CLIENTS));
+
+    for (int i = 0; i < CLIENTS; i++) {
+        EXPECT_EQ(host_socket_frames(server->client(i)), std::vector<std::string> { text });
+        EXPECT_EQ(server->client(i).writes, 1u);
+    }
+}
+
+// Timing, with the web server task on a thread of its own
+class Sending : public ::testing::Test {
+protected:
+    static const int COALESCETIME = 5;    // As in Serial2Socket.h, in ms
+    static const int FLUSHTIMEOUT = 500;  // As in Serial2Socket.h, in ms
+
+    // The task sleeps wait ticks between passes unless woken. It is left idle, with no
+    // notification pending, so only what the test does next wakes it.
+    void start(TickType_t wait, bool resume = true) {
+        millis();  // The host clock starts at its first reading, and the last send was at 0
+        server.reset(new HostSocketServer(1));
+        task.reset(new HostSenderTask(*server, [] { Serial2Socket.handle_flush(); }, wait));
+        Serial2Socket.attachWS(server.get(), task->handle());
+        if (resume) {
+            task->resume();
+        }
+        vTaskDelay(2 * COALESCETIME);  // Longer than that since any send in an earlier test
+    }
+    void TearDown() override {
+        task.reset();
+        Serial2Socket.detachWS();
+    }
+
+    std::vector<std::string> frames() {
+        task->stop();
+        return host_socket_frames(server->client(0));
+    }
+
+    std::unique_ptr<HostSocketServer> server;
+    std::unique_ptr<HostSenderTask>   task;
+};
+
+TEST_F(Sending, LineEndWakesTheSender) {
+    start(10000);  // Only a notification wakes it in time
+    int64_t start = micros();
+    Serial2Socket.write("ok\r\n");
+    ASSERT_TRUE(task->wait_sent(1, 1000));
+    EXPECT_LT(task->sent_at(0) - start, 100000);
+    EXPECT_EQ(frames(), std::vector<std::string> { "ok\r\n" });
+}
+
+TEST_F(Sending, BurstOfLinesIsOneFrame) {
+    start(1);
+    Serial2Socket.write("ok\r\n");
+    ASSERT_TRUE(task->wait_sent(1, 1000));
+    std::string burst = lines(400);
+    for (size_t pos = 0; pos < burst.size(); pos += 40) {
+        Serial2Socket.write(burst.substr(pos, 40).c_str());
+    }
+    ASSERT_TRUE(task->wait_sent(2, 1000));
+    EXPECT_GE(task->sent_at(1) - task->sent_at(0), (COALESCETIME - 2) * 1000);
+    vTaskDelay(4 * COALESCETIME);
+    EXPECT_EQ(frames(), (std::vector<std::string> { "ok\r\n", burst }));
+}
+
+TEST_F(Sending, PartialLineIsSentAfterFlushTimeout) {
+    start(1);
+    int64_t start = micros();
+    Serial2Socket.write("<Idle|MPos:0.000");
+    ASSERT_TRUE(task->wait_sent(1, 2 * FLUSHTIMEOUT));
+    EXPECT_GE(task->sent_at(0) - start, (FLUSHTIMEOUT - 1) * 1000);
+    EXPECT_LT(task->sent_at(0) - start, (FLUSHTIMEOUT + 200) * 1000);
+    EXPECT_EQ(frames(), std::vector<std::string> { "<Idle|MPos:0.000" });
+}
+
+// A writer waits for a full buffer to be taken for FLUSHTIMEOUT, then drops its output
+TEST_F(Sending, OutputIsDroppedWhenTheBufferStaysFull) {
+    start(1, false);  // Like a web server task held up by a slow browser
+    std::string full = lines(1200);
+    Serial2Socket.write((const uint8_t*)full.data(), full.size());
+    int64_t start = micros();
+    EXPECT_EQ(Serial2Socket.write("ok\r\n"), 4u);
+    EXPECT_GE(micros() - start, (FLUSHTIMEOUT - 1) * 1000);
+
+    task->resume();
+    ASSERT_TRUE(task->wait_sent(1, 1000));
+    vTaskDelay(4 * COALESCETIME);
+    EXPECT_EQ(frames(), std::vector<std::string> { full });
+}
@@ -0,0 +1,100 @@
+/*
+  UploadWriterTest.cpp - Tests of WebUI/UploadWriter.cpp
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+#include "WebUI/UploadWriter.h"
+
+#include <SD.h>
+#include <gtest/gtest.h>
+
+using WebUI::UploadWriter;
+
+// Like the web server's, the writer outlives every upload, and its task with it
+static UploadWriter writer;
+
+static const size_t CHUNK = 1436;  // What the HTTP server hands over at a time
+
+class Upload : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SD.remove("/upload.nc");
+        SD.volume().writes = 0;
+        SD.volume().space  = SIZE_MAX;
+    }
+
+    // Upload data, generated from its length, in HTTP sized chunks
+    static std::string data(size_t len) {
+        std::string text;
+        for (size_t i = 0; text.size() < len; i++) {
+            text += "G1 X" + std::to_string(i % 1000) + " Y" + std::to_string(i * 7 % 1000) + "\n";
+        }
+        text.resize(len);
+        return text;
+    }
+    static bool send(const std::string& text) {
+        bool ok = true;
+        for (size_t pos = 0; pos < text.size(); pos += CHUNK) {
+            ok = writer.write((const uint8_t*)text.data() + pos, std::min(CHUNK, text.size() - pos)) && ok;
+        }
+        return ok;
+    }
+};
+
+TEST_F(Upload, WritesWholeBlocks) {
+    for (size_t len : { size_t(0), size_t(100), size_t(UploadWriter::BUFFER_SIZE), size_t(5 * UploadWriter::BUFFER_SIZE + 1234) }) {
+        SetUp();
+        File        file = SD.open("/upload.nc", FILE_WRITE);
+        std::string text = data(len);
+        writer.begin(file);
+        EXPECT_TRUE(send(text));
+        EXPECT_TRUE(writer.end());
+        file.close();
+        EXPECT_EQ(text, SD.get("/upload.nc")) << len << " bytes";
+        EXPECT_EQ((len + UploadWriter::BUFFER_SIZE - 1) / UploadWriter::BUFFER_SIZE, SD.volume().writes) << len << " bytes";
+    }
+}
+
+TEST_F(Upload, ReportsAFailedWrite) {
+    SD.volume().space = 2 * UploadWriter::BUFFER_SIZE + 10;  // The card fills during the third block
+    File file         = SD.open("/upload.nc", FILE_WRITE);
+    writer.begin(file);
+    send(data(4 * UploadWriter::BUFFER_SIZE));
+    EXPECT_FALSE(writer.end());
+    file.close();
+    EXPECT_EQ(size_t(2 * UploadWriter::BUFFER_SIZE), SD.get("/upload.nc").size());
+}
+
+TEST_F(Upload, AbortDropsWhatIsQueued) {
+    File file = SD.open("/upload.nc", FILE_WRITE);
+    writer.begin(file);
+    send(data(UploadWriter::BUFFER_SIZE / 2));
+    writer.abort();
+    EXPECT_FALSE(writer.end());
+    EXPECT_FALSE(writer.write((const uint8_t*)"x", 1));
+    file.close();
+    EXPECT_EQ("", SD.get("/upload.nc"));
+
+    // The writer and its task are ready for the next upload
+    file             = SD.open("/upload.nc", FILE_WRITE);
+    std::string text = data(3 * UploadWriter::BUFFER_SIZE);
+    writer.begin(file);
+    EXPECT_TRUE(send(text));
+    EXPECT_TRUE(writer.end());
+    file.close();
+    EXPECT_EQ(text, SD.get("/upload.nc"));
+}
@@ -0,0 +1,56 @@
+/*
+  ParserBench.cpp - Measures how many lines per second the g-code parser runs
+  Part of Grbl_ESP32
+
+  Usage: parser_bench [file.nc [passes]]
+  The file is run from a reset parser on every pass, with motion recorded but
+  not planned, so the figure is the cost of the parser and its replies alone.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <chrono>
+
+int main(int argc, char** argv) {
+    const char* path   = argc > 1 ? argv[1] : GRBL_TEST_FILES "/raster_tree.nc";
+    int         passes = argc > 2 ? atoi(argv[2]) : 10;
+    auto        lines  = host_read_lines(path);
+    if (lines.empty()) {
+        fprintf(stderr, "No lines in %s\n", path);
+        return 1;
+    }
+    host_grbl_init();
+    uint64_t ran    = 0;
+    uint64_t errors = 0;
+    auto     start  = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        gc_init();
+        for (auto& line : lines) {
+            errors += host_execute_line(line.c_str()) != Error::Ok;
+            ran++;
+        }
+        host_motion.clear();
+        host_output[CLIENT_SERIAL].clear();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%s: %llu lines in %.3f s, %.0f lines/s, %llu errors\n",
+           path,
+           (unsigned long long)ran,
+           seconds,
+           ran / seconds,
+           (unsigned long long)errors);
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+  ReportBench.cpp - Measures ReportBuilder against sprintf on status report numbers
+  Part of Grbl_ESP32
+
+  Usage: report_bench [iterations]
+  Each iteration formats the three axis values of a status report, once with
+  ReportBuilder::append_fixed() and once with sprintf("%4.3f"), and prints the
+  time per value of each.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <chrono>
+
+int main(int argc, char** argv) {
+    int   iterations = argc > 1 ? atoi(argv[1]) : 1000000;
+    float position[] = { 123.456f, -78.9f, 0.0005f };
+    char  buf[200];
+    char* volatile sink = buf;  // Keeps the formatted text from being optimized away
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        ReportBuilder rpt(buf, sizeof(buf));
+        for (float value : position) {
+            rpt.append_fixed(value + i * 0.001f, 3);
+            rpt.append(',');
+        }
+        sink[0] = buf[0];
+    }
+    double builder      = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        char* p = buf;
+        for (float value : position) {
+            p += sprintf(p, "%4.3f,", value + i * 0.001f);
+        }
+        sink[0] = buf[0];
+    }
+    double sprintf_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double values = 3.0 * iterations;
+    printf("append_fixed: %.1f ns/value, sprintf: %.1f ns/value, %.2fx faster\n",
+           builder / values * 1e9,
+           sprintf_time / values * 1e9,
+           sprintf_time / builder);
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+  SocketBench.cpp - Measures the web socket frames Serial2Socket broadcasts
+  Part of Grbl_ESP32
+
+  Usage: socket_bench [frames] [clients]
+  Sends the given number of frames to each of the browsers, first through
+  Serial2Socket, which leaves room for the frame header in front of its data,
+  then through broadcastBIN() from a buffer without that room. Prints the
+  frames per second each way, and the heap allocations and socket writes each
+  frame to one browser costs.
+
+  Then times how long output waits in Serial2Socket before its frame goes out,
+  with the web server task on a thread of its own, sleeping a tick between
+  passes as on the controller: a line after a quiet spell, a line soon after
+  the one before, and a partial line. doc/script/websocket_latency.py times
+  the whole round trip through a controller.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+#include "Sockets.h"
+#include "WebUI/Serial2Socket.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+using WebUI::Serial2Socket;
+
+static void measure(const char* name, HostSocketServer& server, int frames, int clients, std::function<void()> send) {
+    size_t bytes       = server.client(0).bytes;
+    size_t writes      = server.client(0).writes;
+    size_t allocations = host_allocations;
+    auto   start       = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        send();
+    }
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double sent = double(frames) * clients;
+    printf("%-24s %10.0f frames/s, %6.1f bytes/frame, %4.2f allocations/frame, %4.2f writes/frame\n",
+           name,
+           sent / time,
+           (server.client(0).bytes - bytes) / double(frames),
+           (host_allocations - allocations) / sent,
+           (server.client(0).writes - writes) / double(frames));
+}
+
+// Writes text samples times, gap ms apart, and prints how long each took to go out
+static void latency(const char* name, HostSenderTask& task, int samples, TickType_t gap, const char* text) {
+    std::vector<double> times;
+    for (int i = 0; i < samples; i++) {
+        vTaskDelay(gap);
+        size_t  sent  = task.sent();
+        int64_t start = micros();
+        Serial2Socket.write(text);
+        if (!task.wait_sent(sent + 1, 2000)) {
+            printf("%-24s no frame\n", name);
+            return;
+        }
+        times.push_back((task.sent_at(sent) - start) / 1000.0);
+    }
+    std::sort(times.begin(), times.end());
+    printf("%-24s %7.3f ms min, %7.3f ms median, %7.3f ms max\n", name, times.front(), times[times.size() / 2], times.back());
+}
+
+int main(int argc, char** argv) {
+    int frames  = argc > 1 ? atoi(argv[1]) : 100000;
+    int clients = argc > 2 ? atoi(argv[2]) : 2;
+    if (clients < 1 || clients > WEBSOCKETS_SERVER_CLIENT_MAX) {
+        fprintf(stderr, "clients must be 1 to %d\n", WEBSOCKETS_SERVER_CLIENT_MAX);
+        return 1;
+    }
+
+    HostSocketServer server(clients);
+    for (int i = 0; i < clients; i++) {
+        server.client(i).keep = false;
+    }
+    Serial2Socket.attachWS(&server, xTaskGetCurrentTaskHandle());  // flush() sends at once
+
+    const char* report = "<Run|MPos:12.345,-6.789,0.000|FS:1500,12000>\r\nok\r\n";
+    std::string full(1200, 'x');
+    uint8_t     small[100]  = {};
+    uint8_t     large[1000] = {};
+
+    measure("Serial2Socket report", server, frames, clients, [&] {
+        Serial2Socket.write(report);
+        Serial2Socket.flush();
+    });
+    measure("Serial2Socket 1200 B", server, frames, clients, [&] {
+        Serial2Socket.write((const uint8_t*)full.data(), full.size());
+        Serial2Socket.flush();
+    });
+    measure("broadcastBIN 100 B", server, frames, clients, [&] { server.broadcastBIN(small, sizeof(small)); });
+    measure("broadcastBIN 1000 B", server, frames, clients, [&] { server.broadcastBIN(large, sizeof(large)); });
+
+    HostSenderTask task(server, [] { Serial2Socket.handle_flush(); }, 1);
+    Serial2Socket.attachWS(&server, task.handle());
+    task.resume();
+    int samples = std::min(frames, 100);
+    latency("line after 10 ms", task, samples, 10, "ok\r\n");
+    latency("line after 1 ms", task, samples, 1, "ok\r\n");
+    latency("partial line", task, std::max(1, samples / 20), 10, "<Idle|MPos:0.000");
+    task.stop();
+
+    Serial2Socket.detachWS();
+    return 0;
+}
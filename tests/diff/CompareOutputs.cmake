@@ -0,0 +1,21 @@
+# Runs two programs with the same arguments and fails if their outputs differ.
+#   cmake -DFIRST=<program> -DSECOND=<program> -DARGS=<a|b|...> -DOUT=<prefix> -P CompareOutputs.cmake
+
+string(REPLACE "|" ";" ARGS "${ARGS}")
+
+execute_process(COMMAND ${FIRST} ${ARGS} OUTPUT_FILE ${OUT}.first RESULT_VARIABLE first_result)
+execute_process(COMMAND ${SECOND} ${ARGS} OUTPUT_FILE ${OUT}.second RESULT_VARIABLE second_result)
+if(NOT first_result EQUAL 0 OR NOT second_result EQUAL 0)
+    message(FATAL_ERROR "${FIRST} returned ${first_result}, ${SECOND} returned ${second_result}")
+endif()
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${OUT}.first ${OUT}.second RESULT_VARIABLE differ)
+if(differ)
+    find_program(DIFF diff)
+    if(DIFF)
+        execute_process(COMMAND ${DIFF} -u ${OUT}.first ${OUT}.second OUTPUT_VARIABLE changes)
+        string(SUBSTRING "${changes}" 0 4000 changes)
+    endif()
+    message(FATAL_ERROR "${OUT}.first and ${OUT}.second differ\n${changes}")
+endif()
+file(SIZE ${OUT}.first size)
+message(STATUS "Outputs match, ${size} bytes")
@@ -0,0 +1,23 @@
+/*
+  GCodeFullParser.cpp - GCode.cpp built without its fast path, for tests/diff
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Config.h is only read once, so the fast path stays off when GCode.cpp includes it again
+#include "Config.h"
+#undef USE_GCODE_FAST_PATH
+
+#include "GCode.cpp"
@@ -0,0 +1,75 @@
+/*
+  ParserTrace.cpp - Prints what the g-code parser does with each line of some files
+  Part of Grbl_ESP32
+
+  Every line is printed with its result, the motion it produced and the parser
+  state after it. The trace of a build with USE_GCODE_FAST_PATH must equal the
+  trace of a build without it.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <filesystem>
+#include <set>
+
+static void print_state() {
+    printf("  state");
+    for (int axis = 0; axis < number_axis->get(); axis++) {
+        printf(" %c%.4f", "XYZABC"[axis], gc_state.position[axis]);
+    }
+    printf(" F%.4f S%.4f N%d G%d sp%d/%d\n",
+           gc_state.feed_rate,
+           gc_state.spindle_speed,
+           gc_state.line_number,
+           int(gc_state.modal.motion),
+           int(gc_state.modal.spindle),
+           int(spindle->get_state()));
+}
+
+static void trace(const std::string& path) {
+    printf("file %s\n", std::filesystem::path(path).filename().c_str());
+    host_grbl_init();
+    for (auto& line : host_read_lines(path.c_str())) {
+        if (line.empty() || line[0] == ';' || line[0] == '?') {
+            continue;
+        }
+        host_motion.clear();
+        printf("%s\n  error:%d\n", line.c_str(), int(host_execute_line(line.c_str())));
+        for (auto& record : host_motion) {
+            printf("  %s\n", host_format_motion(record).c_str());
+        }
+        print_state();
+    }
+}
+
+int main(int argc, char** argv) {
+    for (int arg = 1; arg < argc; arg++) {
+        if (std::filesystem::is_directory(argv[arg])) {
+            std::set<std::string> files;  // In a fixed order, so traces can be compared
+            for (auto& entry : std::filesystem::directory_iterator(argv[arg])) {
+                if (entry.is_regular_file()) {
+                    files.insert(entry.path());
+                }
+            }
+            for (auto& file : files) {
+                trace(file);
+            }
+        } else {
+            trace(argv[arg]);
+        }
+    }
+    return 0;
+}
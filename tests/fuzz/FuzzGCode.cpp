@@ -0,0 +1,51 @@
+/*
+  FuzzGCode.cpp - libFuzzer entry point for the g-code and $ command parsers
+  Part of Grbl_ESP32
+
+  Each input is split into lines and run from a freshly reset parser, the way
+  the protocol loop would run a stream from one client. Build with clang to get
+  the fuzz_gcode target, and run it with the corpus and the test files as seeds:
+
+    fuzz_gcode tests/fuzz/corpus Grbl_Esp32/src/tests
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    host_grbl_init();
+    char   line[LINE_BUFFER_SIZE];
+    size_t len = 0;
+    for (size_t i = 0; i <= size; i++) {
+        char c = i < size ? data[i] : '\n';
+        if (c != '\r' && c != '\n') {
+            if (len < sizeof(line) - 1) {
+                line[len] = c;
+            }
+            len++;  // Too long lines are dropped, as the protocol reports Overflow for them
+            continue;
+        }
+        if (len < sizeof(line)) {
+            line[len] = '\0';
+            host_execute_line(line);
+        }
+        len = 0;
+        host_motion.clear();
+        for (auto& output : host_output) {
+            output.clear();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+/*
+  FuzzReplay.cpp - Runs the fuzz entry point over files, for compilers without libFuzzer
+  Part of Grbl_ESP32
+
+  Arguments are files or directories of files. Each file is one fuzz input.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+static void run(const std::filesystem::path& path) {
+    std::ifstream        file(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+}
+
+int main(int argc, char** argv) {
+    int inputs = 0;
+    for (int arg = 1; arg < argc; arg++) {
+        if (std::filesystem::is_directory(argv[arg])) {
+            for (auto& entry : std::filesystem::directory_iterator(argv[arg])) {
+                if (entry.is_regular_file()) {
+                    run(entry.path());
+                    inputs++;
+                }
+            }
+        } else {
+            run(argv[arg]);
+            inputs++;
+        }
+    }
+    printf("Ran %d inputs\n", inputs);
+    return inputs ? 0 : 1;
+}
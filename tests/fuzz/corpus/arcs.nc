@@ -0,0 +1,7 @@
+g21 g90 g17 f500
+g2 x10 y0 i5 j0
+g3 x0 y0 r5
+g18 g2 x5 z5 i2.5 k2.5
+g19 g3 y1 z1 r-1
+g2 x0 y0 i0 j0
+g20 g2 x1 y1 r0.5
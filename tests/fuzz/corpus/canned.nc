@@ -0,0 +1,8 @@
+g21 g90 g17 f200
+g0 z5
+g98 g81 x1 y1 z-2 r1
+x2
+g99 g82 x3 y3 z-3 r2 p0.5
+g91 g83 x1 z-4 r1 q1 l3
+g80
+g81 z-1 r1 l0
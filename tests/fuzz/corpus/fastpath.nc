@@ -0,0 +1,29 @@
+g21 g90 g94 g54
+g1 x1 f100
+x2 y2
+g0 x0 y0
+n5 g1 x1 s200
+x2 f-1
+x3 f0
+g1 x4 x5
+g1 f200 f300 x1
+g20 x1 f10
+g91 x1
+g90 g55 x1
+g93 x1 f2
+g94 x2
+m3 s1000
+g1 x1 s2000
+x2 s0
+m5 x3
+g1 a1 b1 c1
+g1 z1 t1
+g1 x1 n-5
+n99999999 g1 x1
+g1 g0 x1
+g2 x1
+g80 x1
+g0 x1.5 y-2.25 z+3
+ $
+ (c)$J=G91X1F100
+ $x
@@ -0,0 +1,17 @@
+g20 g91 g0 x1 y2 z3
+g21 g90 g54 g1 x-1 f100 s1000 m3
+g10 l2 p3 x1 y1
+g56 g0 x0
+g10 l20 p1 x0
+g92 x5
+g92.1
+g93 g1 x1 f2
+g94 m5 m8 m9
+g28.1
+g28 g91 x0
+g38.2 z-10 f50
+t1 m6
+g4 p0.25
+n10 g1 x0.5 f1e3
+$j=g91 x1 f100
+m2
@@ -0,0 +1,10 @@
+o100 sub
+g91 g1 x1 f100
+o100 endsub
+o100 call
+o200 repeat [3]
+g0 y1
+o200 endrepeat
+o100 call
+o300 call
+o100 endrepeat
@@ -0,0 +1,15 @@
+g0x1y2z3
+G0 X-.5 Y+.5
+g0 x 1 (comment) y 2 ; tail
+(unterminated
+g0 x1 x2
+g1 g0 x1
+m3 m4
+g0 x1e
+g0 x1..2
+$g
+$#
+$$
+$x
+$c
+$c
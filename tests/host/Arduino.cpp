@@ -0,0 +1,60 @@
+/*
+  Arduino.cpp - Host implementation of the Arduino core stand-in, for the tests in tests/
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#include <chrono>
+#include <thread>
+
+EspClass  ESP;
+WiFiClass WiFi;
+
+int64_t esp_timer_get_time() {
+    static auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis() {
+    return esp_timer_get_time() / 1000;
+}
+
+unsigned long micros() {
+    return esp_timer_get_time();
+}
+
+void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+// There are no pins on the host; outputs are dropped and inputs read low
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t val) {}
+int  digitalRead(uint8_t pin) {
+    return LOW;
+}
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {}
+void detachInterrupt(uint8_t pin) {}
@@ -0,0 +1,188 @@
+/*
+  FS.cpp - Host implementation of the in-memory file system stand-in, for the tests in tests/
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <FS.h>
+#include <SD.h>
+
+SPIClass SPI;
+SDFS     SD;
+
+namespace fs {
+    static std::string parent_of(const std::string& path) {
+        size_t slash = path.rfind('/');
+        return slash == 0 ? "/" : path.substr(0, slash);
+    }
+
+    size_t File::write(const uint8_t* buf, size_t size) {
+        if (!_node || !_writable) {
+            return 0;
+        }
+        if (_pos + size > _node->data.size()) {
+            size_t grow = _pos + size - _node->data.size();
+            if (grow > _volume->space) {
+                return 0;
+            }
+            _volume->space -= grow;
+            _node->data.resize(_pos + size);
+        }
+        memcpy(_node->data.data() + _pos, buf, size);
+        _pos += size;
+        _node->last_write = _volume->clock;
+        _volume->writes++;
+        return size;
+    }
+
+    int File::read() {
+        uint8_t c;
+        return read(&c, 1) ? c : -1;
+    }
+
+    int File::peek() {
+        return available() > 0 ? _node->data[_pos] : -1;
+    }
+
+    size_t File::read(uint8_t* buf, size_t size) {
+        if (!_node || _node->directory) {
+            return 0;
+        }
+        size = std::min(size, _node->data.size() - _pos);
+        if (size) {
+            memcpy(buf, _node->data.data() + _pos, size);  // An empty file has no data()
+        }
+        _pos += size;
+        _volume->reads++;
+        return size;
+    }
+
+    bool File::seek(uint32_t pos, SeekMode mode) {
+        if (!_node) {
+            return false;
+        }
+        size_t base = mode == SeekSet ? 0 : mode == SeekCur ? _pos : _node->data.size();
+        if (base + pos > _node->data.size()) {
+            return false;
+        }
+        _pos = base + pos;
+        return true;
+    }
+
+    void File::close() {
+        _node.reset();
+    }
+
+    File File::openNextFile(const char* mode) {
+        if (!isDirectory()) {
+            return File();
+        }
+        size_t index = 0;
+        for (auto& entry : _volume->nodes) {
+            if (entry.first != "/" && parent_of(entry.first) == _path && index++ == _next) {
+                _next++;
+                return File(_volume, entry.first, entry.second, false);
+            }
+        }
+        return File();
+    }
+
+    File FS::open(const char* path, const char* mode) {
+        auto it = _volume->nodes.find(path);
+        if (mode[0] == 'r') {
+            return it == _volume->nodes.end() ? File() : File(_volume, path, it->second, false);
+        }
+        if (it != _volume->nodes.end() && it->second->directory) {
+            return File();
+        }
+        if (it == _volume->nodes.end()) {
+            auto parent = _volume->nodes.find(parent_of(path));
+            if (parent == _volume->nodes.end() || !parent->second->directory) {
+                return File();
+            }
+            it = _volume->nodes.emplace(path, std::make_shared<Node>()).first;
+        }
+        if (mode[0] == 'w') {
+            it->second->data.clear();
+        }
+        it->second->last_write = _volume->clock;
+        File file(_volume, path, it->second, true);
+        file.seek(0, SeekEnd);
+        return file;
+    }
+
+    bool FS::remove(const char* path) {
+        auto it = _volume->nodes.find(path);
+        if (it == _volume->nodes.end() || it->second->directory) {
+            return false;
+        }
+        _volume->nodes.erase(it);
+        return true;
+    }
+
+    bool FS::rename(const char* from, const char* to) {
+        auto it = _volume->nodes.find(from);
+        if (it == _volume->nodes.end() || exists(to) || !exists(parent_of(to).c_str())) {
+            return false;
+        }
+        std::string prefix = std::string(from) + "/";
+        for (auto child = _volume->nodes.begin(); child != _volume->nodes.end();) {
+            if (child->first.compare(0, prefix.length(), prefix) == 0) {
+                _volume->nodes[to + child->first.substr(strlen(from))] = child->second;
+                child                                                   = _volume->nodes.erase(child);
+            } else {
+                ++child;
+            }
+        }
+        auto node = it->second;
+        _volume->nodes.erase(from);
+        _volume->nodes[to] = node;
+        return true;
+    }
+
+    bool FS::mkdir(const char* path) {
+        if (exists(path) || !exists(parent_of(path).c_str())) {
+            return false;
+        }
+        _volume->nodes[path] = std::make_shared<Node>(Node { true });
+        return true;
+    }
+
+    bool FS::rmdir(const char* path) {
+        auto it = _volume->nodes.find(path);
+        if (it == _volume->nodes.end() || !it->second->directory || strcmp(path, "/") == 0) {
+            return false;
+        }
+        for (auto& entry : _volume->nodes) {
+            if (entry.first != "/" && parent_of(entry.first) == path) {
+                return false;
+            }
+        }
+        _volume->nodes.erase(it);
+        return true;
+    }
+
+    void FS::put(const char* path, const std::string& data) {
+        auto node            = std::make_shared<Node>();
+        node->data           = std::vector<uint8_t>(data.begin(), data.end());
+        node->last_write     = _volume->clock;
+        _volume->nodes[path] = node;
+    }
+
+    std::string FS::get(const char* path) {
+        auto it = _volume->nodes.find(path);
+        return it == _volume->nodes.end() ? std::string() : std::string(it->second->data.begin(), it->second->data.end());
+    }
+}
@@ -0,0 +1,239 @@
+/*
+  FreeRTOS.cpp - Host implementation of the FreeRTOS stand-in, for the tests in tests/
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <freertos/FreeRTOS.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct host_task {
+    std::mutex              lock;
+    std::condition_variable wake;
+    uint32_t                notified = 0;
+};
+
+// As on FreeRTOS, the storage for the items is allocated when the queue is created
+struct host_queue {
+    std::mutex              lock;
+    std::condition_variable changed;
+    std::vector<uint8_t>    storage;    // length items, a ring starting at head
+    UBaseType_t             head  = 0;
+    UBaseType_t             count = 0;  // Items in the queue
+    UBaseType_t             length;
+    UBaseType_t             item_size;
+};
+
+struct host_mux {
+    std::recursive_mutex lock;
+};
+
+// Thrown by vTaskDelete(NULL) to unwind a task's thread, which must not return on the target
+struct host_task_exit {};
+
+static thread_local host_task* current_task = nullptr;
+static std::mutex              mux_init;
+
+// Made for threads that were not created as tasks, kept for as long as a handle might be
+static std::vector<std::unique_ptr<host_task>> adopted_tasks;
+static std::mutex                              adopted_lock;
+
+static auto deadline(TickType_t ticks) {
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(ticks);
+}
+
+void vPortCPUInitializeMutex(portMUX_TYPE* mux) {
+    mux->mux = new host_mux;
+}
+
+void vTaskEnterCritical(portMUX_TYPE* mux) {
+    {
+        std::lock_guard<std::mutex> guard(mux_init);
+        if (!mux->mux) {
+            mux->mux = new host_mux;  // portMUX_INITIALIZER_UNLOCKED
+        }
+    }
+    mux->mux->lock.lock();
+}
+
+void vTaskExitCritical(portMUX_TYPE* mux) {
+    mux->mux->lock.unlock();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn,
+                                   const char*    name,
+                                   uint32_t       stack,
+                                   void*          param,
+                                   UBaseType_t    priority,
+                                   TaskHandle_t*  handle,
+                                   BaseType_t     core) {
+    host_task* task = new host_task;
+    if (handle) {
+        *handle = task;
+    }
+    std::thread([=] {
+        current_task = task;
+        try {
+            fn(param);
+        } catch (host_task_exit&) {}
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* param, UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, name, stack, param, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+void vTaskDelayUntil(TickType_t* previous_wake, TickType_t ticks) {
+    *previous_wake += ticks;
+    TickType_t now = xTaskGetTickCount();
+    if (TickType_t(*previous_wake - now) <= ticks) {
+        vTaskDelay(*previous_wake - now);
+    }
+}
+
+// Only a task may delete itself here; the thread of another task cannot be stopped from outside
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || task == current_task) {
+        throw host_task_exit();
+    }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (!current_task) {
+        std::lock_guard<std::mutex> guard(adopted_lock);
+        adopted_tasks.emplace_back(new host_task);  // e.g. main()
+        current_task = adopted_tasks.back().get();
+    }
+    return current_task;
+}
+
+TickType_t xTaskGetTickCount() {
+    static auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    std::lock_guard<std::mutex> guard(task->lock);
+    task->notified++;
+    task->wake.notify_all();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+    host_task*                   task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> guard(task->lock);
+    task->wake.wait_until(guard, deadline(ticks), [task] { return task->notified != 0; });
+    uint32_t value = task->notified;
+    if (value) {
+        task->notified = clear ? 0 : value - 1;
+    }
+    return value;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return 0;
+}
+
+BaseType_t xPortInIsrContext() {
+    return pdFALSE;
+}
+
+size_t xPortGetFreeHeapSize() {
+    return 0;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    host_queue* queue = new host_queue;
+    queue->length     = length;
+    queue->item_size  = item_size;
+    queue->storage.resize(size_t(length) * item_size);
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!queue->changed.wait_until(guard, deadline(ticks), [queue] { return queue->count < queue->length; })) {
+        return pdFAIL;
+    }
+    if (queue->item_size) {
+        memcpy(&queue->storage[(queue->head + queue->count) % queue->length * queue->item_size], item, queue->item_size);
+    }
+    queue->count++;
+    queue->changed.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!queue->changed.wait_until(guard, deadline(ticks), [queue] { return queue->count != 0; })) {
+        return pdFAIL;
+    }
+    if (queue->item_size) {
+        memcpy(item, &queue->storage[queue->head * queue->item_size], queue->item_size);
+    }
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    queue->changed.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    queue->head  = 0;
+    queue->count = 0;
+    queue->changed.notify_all();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return queue->count;
+}
+
+BaseType_t xQueueIsQueueFullFromISR(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return queue->count >= queue->length;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+// As on FreeRTOS, a mutex is a queue of one empty item that is present while the mutex is free
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    QueueHandle_t queue = xQueueCreate(1, 0);
+    xQueueSend(queue, nullptr, 0);
+    return queue;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    return xQueueReceive(sem, nullptr, ticks);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    return xQueueSend(sem, nullptr, 0);
+}
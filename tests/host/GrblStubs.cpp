@@ -0,0 +1,233 @@
+/*
+  GrblStubs.cpp - Stand-ins for the Grbl_ESP32 modules that are not built on the host
+  Part of Grbl_ESP32
+
+  Motion control records what the parser asks of it in host_motion. Everything
+  else does nothing. All of these are weak, so a test that builds the real
+  module gets the real one.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#define WEAK __attribute__((weak))
+
+// System.cpp
+WEAK system_t               sys;
+WEAK int32_t                sys_position[MAX_N_AXIS];
+WEAK int32_t                sys_probe_position[MAX_N_AXIS];
+WEAK volatile Probe         sys_probe_state;
+WEAK volatile ExecState     sys_rt_exec_state;
+WEAK volatile ExecAlarm     sys_rt_exec_alarm;
+WEAK volatile ExecAccessory sys_rt_exec_accessory_override;
+WEAK volatile Percent       sys_rt_f_override;
+WEAK volatile Percent       sys_rt_r_override;
+WEAK volatile Percent       sys_rt_s_override;
+WEAK volatile bool          cycle_stop;
+WEAK volatile void*         sys_pl_data_inflight;
+WEAK volatile bool          sys_rt_exec_debug;
+
+WEAK ControlPins system_control_get_state() {
+    return ControlPins {};
+}
+WEAK uint8_t system_check_safety_door_ajar() {
+    return false;
+}
+WEAK void system_flag_wco_change() {
+    host_wco_changes++;
+    sys.report_wco_counter = 0;
+}
+WEAK void system_convert_array_steps_to_mpos(float* position, int32_t* steps) {
+    for (int idx = 0; idx < number_axis->get(); idx++) {
+        position[idx] = steps[idx] / axis_settings[idx]->steps_per_mm->get();
+    }
+}
+WEAK float* system_get_mpos() {
+    static float position[MAX_N_AXIS];
+    system_convert_array_steps_to_mpos(position, sys_position);
+    return position;
+}
+WEAK bool sys_set_digital(uint8_t io_num, bool turnOn) {
+    return true;
+}
+WEAK bool sys_set_analog(uint8_t io_num, float percent) {
+    return true;
+}
+
+// MotionControl.cpp and Jog.cpp
+static MotionRecord& record_motion(MotionRecord::Kind kind, const float* target, const plan_line_data_t* pl_data) {
+    host_motion.push_back(MotionRecord {});
+    MotionRecord& record = host_motion.back();
+    record.kind          = kind;
+    if (target) {
+        memcpy(record.target, target, sizeof(record.target));
+    }
+    if (pl_data) {
+        record.pl_data = *pl_data;
+    }
+    return record;
+}
+
+WEAK bool cartesian_to_motors(float* target, plan_line_data_t* pl_data, float* position) {
+    record_motion(MotionRecord::Kind::Line, target, pl_data);
+    return true;
+}
+WEAK void mc_arc(float*            target,
+                 plan_line_data_t* pl_data,
+                 float*            position,
+                 float*            offset,
+                 float             radius,
+                 uint8_t           axis_0,
+                 uint8_t           axis_1,
+                 uint8_t           axis_linear,
+                 uint8_t           is_clockwise_arc) {
+    MotionRecord& record    = record_motion(MotionRecord::Kind::Arc, target, pl_data);
+    record.offset[0]        = offset[axis_0];
+    record.offset[1]        = offset[axis_1];
+    record.radius           = radius;
+    record.is_clockwise_arc = is_clockwise_arc;
+}
+WEAK bool mc_dwell(int32_t milliseconds) {
+    record_motion(MotionRecord::Kind::Dwell, nullptr, nullptr).milliseconds = milliseconds;
+    return true;
+}
+WEAK GCUpdatePos mc_probe_cycle(float* target, plan_line_data_t* pl_data, uint8_t parser_flags) {
+    record_motion(MotionRecord::Kind::Probe, target, pl_data);
+    return GCUpdatePos::Target;
+}
+WEAK void mc_homing_cycle(uint8_t cycle_mask) {}
+WEAK void mc_reset() {}
+WEAK Error jog_execute(plan_line_data_t* pl_data, parser_block_t* gc_block, bool* cancelledInflight) {
+    record_motion(MotionRecord::Kind::Jog, gc_block->values.xyz, pl_data);
+    return Error::Ok;
+}
+
+// Protocol.cpp
+WEAK void protocol_buffer_synchronize() {}
+WEAK void protocol_exec_rt_system() {}
+WEAK void protocol_execute_realtime() {}
+WEAK Error execute_line(char* line, uint8_t client, WebUI::AuthenticationLevel auth_level) {
+    if (line[0] == 0) {
+        return Error::Ok;
+    }
+    if (line[0] == '$' || line[0] == '[') {
+        return system_execute_line(line, client, auth_level);
+    }
+    return gc_execute_line(line, client);
+}
+WEAK Error execute_block(const gc_words_t* block, uint8_t client) {
+    return gc_execute_block(block, client);
+}
+
+// Planner.cpp, Stepper.cpp and Motors.cpp
+WEAK uint8_t plan_get_block_buffer_available() {
+    return 16;
+}
+WEAK float st_get_realtime_rate() {
+    return 0.0;
+}
+WEAK void st_go_idle() {}
+WEAK void motors_read_settings() {}
+WEAK void motors_set_disable(bool disable, uint8_t mask) {}
+
+// CoolantControl.cpp, Limits.cpp and Probe.cpp
+static CoolantState coolant_state;
+
+WEAK CoolantState coolant_get_state() {
+    return coolant_state;
+}
+WEAK void coolant_off() {
+    coolant_state = {};
+}
+WEAK void coolant_sync(CoolantState state) {
+    coolant_state = state;
+}
+WEAK void     limitsCheckSoft(float* target) {}
+WEAK AxisMask limits_get_state() {
+    return 0;
+}
+WEAK float limitsMaxPosition(uint8_t axis) {
+    float mpos = axis_settings[axis]->home_mpos->get();
+    return bitnum_istrue(homing_dir_mask->get(), axis) ? mpos + axis_settings[axis]->max_travel->get() : mpos;
+}
+WEAK float limitsMinPosition(uint8_t axis) {
+    float mpos = axis_settings[axis]->home_mpos->get();
+    return bitnum_istrue(homing_dir_mask->get(), axis) ? mpos : mpos - axis_settings[axis]->max_travel->get();
+}
+WEAK bool probe_get_state() {
+    return false;
+}
+
+// Spindles/Spindle.cpp, with a spindle that only keeps its state
+namespace Spindles {
+    class Host : public Spindle {
+    public:
+        void     init() override {}
+        uint32_t set_rpm(uint32_t rpm) override { return rpm; }
+        void     set_state(SpindleState state, uint32_t rpm) override { _current_state = state; }
+        SpindleState get_state() override { return _current_state; }
+        void         stop() override { _current_state = SpindleState::Disable; }
+        void         config_message() override {}
+    };
+    static Host host;
+
+    WEAK void Spindle::select() { spindle = &host; }
+    WEAK bool Spindle::inLaserMode() { return false; }
+    WEAK void Spindle::sync(SpindleState state, uint32_t rpm) { set_state(state, rpm); }
+    WEAK void Spindle::deinit() { stop(); }
+}
+WEAK Spindles::Spindle* spindle;
+
+// SDCard.cpp
+WEAK bool    SD_ready_next = false;
+WEAK SDState get_sd_state(bool refresh) {
+    return SDState::Idle;
+}
+WEAK boolean closeFile() {
+    return true;
+}
+WEAK float sd_report_perc_complete() {
+    return 0.0;
+}
+WEAK uint32_t sd_get_current_line_number() {
+    return 0;
+}
+WEAK void sd_get_current_filename(char* name) {
+    name[0] = '\0';
+}
+
+// Grbl.cpp
+WEAK void user_m30() {}
+WEAK void user_tool_change(uint8_t new_tool) {}
+
+// WebUI
+namespace WebUI {
+    WEAK BluetoothSerial SerialBT;
+    WEAK const char*     BTConfig::info() { return "BT=Disabled"; }
+    WEAK void            BTConfig::reset_settings() {}
+    WEAK const char*     WiFiConfig::info() { return "WiFi=Disabled"; }
+    WEAK bool            WiFiConfig::isPasswordValid(const char* password) { return true; }
+    WEAK void            WiFiConfig::reset_settings() {}
+    WEAK String          WiFiConfig::_hostname;
+    WEAK bool            COMMANDS::isLocalPasswordValid(char* password) { return true; }
+    WEAK void            COMMANDS::wait(uint32_t milliseconds) { delay(milliseconds); }
+    WEAK void            make_web_settings() {}
+
+    WEAK Telnet_Server::Telnet_Server() {}
+    WEAK Telnet_Server::~Telnet_Server() {}
+    WEAK int           Telnet_Server::get_rx_buffer_available(uint8_t client) { return 0; }
+    WEAK int           Telnet_Server::index_of(uint8_t client) { return -1; }
+    WEAK Telnet_Server telnet_server;
+}
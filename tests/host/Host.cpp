@@ -0,0 +1,127 @@
+/*
+  Host.cpp - Runs Grbl_ESP32 modules on a Linux host, for the tests in tests/
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <fstream>
+
+std::vector<MotionRecord> host_motion;
+std::string               host_output[CLIENT_COUNT];
+uint32_t                  host_wco_changes = 0;
+
+void client_write(uint8_t client, const char* text) {
+    client_write(client, text, strlen(text));
+}
+
+void client_write(uint8_t client, const char* text, size_t len) {
+    for (uint8_t c = 0; c < CLIENT_COUNT; c++) {
+        if (c != CLIENT_INPUT && (client == c || client == CLIENT_ALL)) {
+            host_output[c].append(text, len);
+        }
+    }
+}
+
+uint8_t client_get_rx_buffer_available(uint8_t client) {
+    return 128;
+}
+
+void host_grbl_init() {
+    static bool settings_made = false;
+    if (!settings_made) {
+        settings_init();
+        settings_made = true;
+    }
+    settings_restore(SettingsRestore::Defaults | SettingsRestore::Parameters);
+    memset(&sys, 0, sizeof(system_t));
+    memset(sys_position, 0, sizeof(sys_position));
+    memset(sys_probe_position, 0, sizeof(sys_probe_position));
+    sys.state               = State::Idle;
+    sys.f_override          = FeedOverride::Default;
+    sys.r_override          = RapidOverride::Default;
+    sys.spindle_speed_ovr   = SpindleSpeedOverride::Default;
+    sys_rt_exec_state.value = 0;
+    Spindles::Spindle::select();
+    gc_init();
+    gc_sync_position();
+    host_motion.clear();
+    for (auto& output : host_output) {
+        output.clear();
+    }
+    host_wco_changes = 0;
+}
+
+Error host_execute_line(const char* line, uint8_t client) {
+    char buffer[LINE_BUFFER_SIZE];
+    snprintf(buffer, sizeof(buffer), "%s", line);
+    if (buffer[0] == 0) {
+        return Error::Ok;
+    }
+    if (buffer[0] == '$' || buffer[0] == '[') {
+        return system_execute_line(buffer, client, WebUI::AuthenticationLevel::LEVEL_ADMIN);
+    }
+    if (sys.state == State::Alarm || sys.state == State::Jog) {
+        return Error::SystemGcLock;
+    }
+    return gc_execute_line(buffer, client);
+}
+
+std::vector<std::string> host_read_lines(const char* path) {
+    std::vector<std::string> lines;
+    std::ifstream            file(path);
+    std::string              line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+std::string host_format_motion(const MotionRecord& record) {
+    static const char* kinds[] = { "line", "arc", "dwell", "probe", "jog" };
+    std::string        text    = kinds[int(record.kind)];
+    char               field[64];
+    if (record.kind == MotionRecord::Kind::Dwell) {
+        snprintf(field, sizeof(field), " P%d", record.milliseconds);
+        return text + field;
+    }
+    for (int axis = 0; axis < number_axis->get(); axis++) {
+        snprintf(field, sizeof(field), " %c%.4f", "XYZABC"[axis], record.target[axis]);
+        text += field;
+    }
+    if (record.kind == MotionRecord::Kind::Arc) {
+        snprintf(field, sizeof(field), " I%.4f J%.4f R%.4f %s", record.offset[0], record.offset[1], record.radius, record.is_clockwise_arc ? "cw" : "ccw");
+        text += field;
+    }
+    const PlMotion&     motion  = record.pl_data.motion;
+    const CoolantState& coolant = record.pl_data.coolant;
+    snprintf(field,
+             sizeof(field),
+             " F%.4f S%u %s%s%s%s sp%d co%d%d",
+             record.pl_data.feed_rate,
+             record.pl_data.spindle_speed,
+             motion.rapidMotion ? "r" : "-",
+             motion.systemMotion ? "s" : "-",
+             motion.noFeedOverride ? "n" : "-",
+             motion.inverseTime ? "i" : "-",
+             int(record.pl_data.spindle),
+             coolant.Mist,
+             coolant.Flood);
+    return text + field;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+/*
+  Host.h - Runs Grbl_ESP32 modules on a Linux host, for the tests in tests/
+  Part of Grbl_ESP32
+
+  The modules a test builds run unchanged. Motion control is replaced by a
+  recorder and the serial clients by string buffers, so a test can feed in
+  lines and look at the motion and replies they produce.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Grbl.h"
+
+#include <string>
+#include <vector>
+
+// One call from the parser into motion control
+struct MotionRecord {
+    enum class Kind : uint8_t { Line, Arc, Dwell, Probe, Jog };
+    Kind             kind;
+    float            target[MAX_N_AXIS];
+    plan_line_data_t pl_data;
+    float            offset[MAX_N_AXIS];  // Arc center offset
+    float            radius;              // Arc radius
+    bool             is_clockwise_arc;
+    int32_t          milliseconds;  // Dwell time
+};
+
+extern std::vector<MotionRecord> host_motion;                // Everything sent to motion control, oldest first
+extern std::string               host_output[CLIENT_COUNT];  // Everything sent to each client
+extern uint32_t                  host_wco_changes;           // Calls to system_flag_wco_change()
+
+// Loads the default settings and resets the parser and the system state, as a boot does
+void host_grbl_init();
+
+// Runs one line the way the protocol loop does, without the line collection
+Error host_execute_line(const char* line, uint8_t client = CLIENT_SERIAL);
+
+// The lines of a text file, without their line ends
+std::vector<std::string> host_read_lines(const char* path);
+
+// One line of text per record, for comparing motion between runs
+std::string host_format_motion(const MotionRecord& record);
@@ -0,0 +1,31 @@
+/*
+  NotificationsStubs.cpp - Stand-in for WebUI/NotificationsService.cpp, for the tests in tests/
+  Part of Grbl_ESP32
+
+  Kept apart from GrblStubs.cpp because it defines an object with a constructor.
+  A weak definition of it would still be constructed and destroyed alongside the
+  real one. As a separate member of the library, the linker leaves this file out
+  of a test that builds the real service.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+namespace WebUI {
+    NotificationsService::NotificationsService() {}
+    NotificationsService::~NotificationsService() {}
+    bool                 NotificationsService::queueMSG(const char* title, const char* message) { return false; }
+    NotificationsService notificationsservice;
+}
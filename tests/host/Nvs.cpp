@@ -0,0 +1,115 @@
+/*
+  Nvs.cpp - Host implementation of the NVS stand-in, for the tests in tests/
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <nvs.h>
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+
+static std::map<std::string, std::string> nvs_values;
+static std::mutex                         nvs_lock;
+
+template <typename T>
+static esp_err_t get_value(const char* key, T* out_value) {
+    std::lock_guard<std::mutex> guard(nvs_lock);
+    auto                        it = nvs_values.find(key);
+    if (it == nvs_values.end() || it->second.size() != sizeof(T)) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    memcpy(out_value, it->second.data(), sizeof(T));
+    return ESP_OK;
+}
+
+static esp_err_t set_value(const char* key, const void* value, size_t length) {
+    std::lock_guard<std::mutex> guard(nvs_lock);
+    nvs_values[key].assign(static_cast<const char*>(value), length);
+    return ESP_OK;
+}
+
+static esp_err_t get_bytes(const char* key, void* out_value, size_t* length) {
+    std::lock_guard<std::mutex> guard(nvs_lock);
+    auto                        it = nvs_values.find(key);
+    if (it == nvs_values.end()) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (out_value) {
+        if (*length < it->second.size()) {
+            return ESP_ERR_NVS_INVALID_LENGTH;
+        }
+        memcpy(out_value, it->second.data(), it->second.size());
+    }
+    *length = it->second.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char* name, nvs_open_mode open_mode, nvs_handle* out_handle) {
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats) {
+    std::lock_guard<std::mutex> guard(nvs_lock);
+    *nvs_stats              = {};
+    nvs_stats->used_entries = nvs_values.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_all(nvs_handle handle) {
+    std::lock_guard<std::mutex> guard(nvs_lock);
+    nvs_values.clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle handle, const char* key) {
+    std::lock_guard<std::mutex> guard(nvs_lock);
+    return nvs_values.erase(key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_get_i8(nvs_handle handle, const char* key, int8_t* out_value) {
+    return get_value(key, out_value);
+}
+
+esp_err_t nvs_set_i8(nvs_handle handle, const char* key, int8_t value) {
+    return set_value(key, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_i32(nvs_handle handle, const char* key, int32_t* out_value) {
+    return get_value(key, out_value);
+}
+
+esp_err_t nvs_set_i32(nvs_handle handle, const char* key, int32_t value) {
+    return set_value(key, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_str(nvs_handle handle, const char* key, char* out_value, size_t* length) {
+    return get_bytes(key, out_value, length);
+}
+
+esp_err_t nvs_set_str(nvs_handle handle, const char* key, const char* value) {
+    return set_value(key, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_get_blob(nvs_handle handle, const char* key, void* out_value, size_t* length) {
+    return get_bytes(key, out_value, length);
+}
+
+esp_err_t nvs_set_blob(nvs_handle handle, const char* key, const void* value, size_t length) {
+    return set_value(key, value, length);
+}
@@ -0,0 +1,160 @@
+/*
+  Sockets.cpp - Browsers on the web socket server, for the tests in tests/
+  Part of Grbl_ESP32
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Sockets.h"
+
+#include <chrono>
+#include <new>
+
+size_t host_allocations = 0;
+
+// Programs that link this file are linked with --wrap=malloc, which sends the calls
+// to malloc() in their own objects here. The C++ library allocates through operator new.
+extern "C" void* __real_malloc(size_t size);
+extern "C" void* __wrap_malloc(size_t size) {
+    host_allocations++;
+    return __real_malloc(size);
+}
+
+void* operator new(size_t size) {
+    host_allocations++;
+    void* p = __real_malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t size) noexcept {
+    free(p);
+}
+
+HostSocketClient::HostSocketClient() {
+    data.reserve(1 << 20);
+}
+
+size_t HostSocketClient::write(const uint8_t* buffer, size_t size) {
+    if (keep) {
+        data.insert(data.end(), buffer, buffer + size);
+    }
+    bytes += size;
+    writes++;
+    return size;
+}
+
+HostSocketServer::HostSocketServer(int clients) : WebSocketsServer(81) {
+    for (int i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+        // The library clears its clients with memset, which the host String does not survive
+        new (&_clients[i]) WSclient_t();
+        _clients[i].num = i;
+        if (i < clients) {
+            _clients[i].tcp    = new HostSocketClient;
+            _clients[i].status = WSC_CONNECTED;
+        }
+    }
+}
+
+std::vector<std::string> host_socket_frames(const HostSocketClient& client) {
+    std::vector<std::string> frames;
+    const std::vector<uint8_t>& data = client.data;
+    size_t                      pos  = 0;
+    while (data.size() - pos >= 2 && data[pos] == (0x80 | WSop_binary) && !(data[pos + 1] & 0x80)) {
+        size_t length = data[pos + 1];
+        size_t header = 2;
+        if (length >= 126) {
+            size_t extra = length == 126 ? 2 : 8;
+            if (data.size() - pos < 2 + extra) {
+                break;
+            }
+            length = 0;
+            for (size_t i = 0; i < extra; i++) {
+                length = length << 8 | data[pos + 2 + i];
+            }
+            header += extra;
+        }
+        if (data.size() - pos - header < length) {
+            break;
+        }
+        frames.emplace_back(data.begin() + pos + header, data.begin() + pos + header + length);
+        pos += header + length;
+    }
+    return frames;
+}
+
+HostSenderTask::HostSenderTask(HostSocketServer& server, std::function<void()> pass, TickType_t wait) :
+    _server(server), _pass(pass), _wait(wait) {
+    _thread = std::thread([this] {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _handle = xTaskGetCurrentTaskHandle();
+        }
+        _changed.notify_all();
+        run();
+    });
+    std::unique_lock<std::mutex> guard(_lock);
+    _changed.wait_for(guard, std::chrono::seconds(10), [this] { return _handle != NULL; });  // wait() is newer than the test runtime
+}
+
+void HostSenderTask::run() {
+    size_t writes = _server.client(0).writes;
+    while (!_stopping) {
+        if (_running) {
+            _pass();
+            if (_server.client(0).writes != writes) {
+                std::lock_guard<std::mutex> guard(_lock);
+                for (; writes < _server.client(0).writes; writes++) {
+                    _sent.push_back(micros());
+                }
+                _changed.notify_all();
+            }
+        }
+        ulTaskNotifyTake(pdTRUE, _wait);
+    }
+}
+
+void HostSenderTask::resume() {
+    _running = true;
+    xTaskNotifyGive(_handle);
+}
+
+void HostSenderTask::stop() {
+    if (_thread.joinable()) {
+        _stopping = true;
+        xTaskNotifyGive(_handle);
+        _thread.join();
+    }
+}
+
+bool HostSenderTask::wait_sent(size_t count, uint32_t ms) {
+    std::unique_lock<std::mutex> guard(_lock);
+    return _changed.wait_for(guard, std::chrono::milliseconds(ms), [&] { return _sent.size() >= count; });
+}
+
+size_t HostSenderTask::sent() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _sent.size();
+}
+
+int64_t HostSenderTask::sent_at(size_t frame) {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _sent.at(frame);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+/*
+  Sockets.h - Browsers on the web socket server, for the tests in tests/
+  Part of Grbl_ESP32
+
+  The arduinoWebSockets server runs unchanged. Its clients are stand-ins
+  that are always connected and keep what is sent to them, and the heap
+  allocations made while it sends are counted.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <WebSocketsServer.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A connected browser. What it receives is kept in data, which has room set aside
+// so that keeping it does not allocate; with keep cleared only the bytes are counted.
+class HostSocketClient : public WiFiClient {
+public:
+    HostSocketClient();
+
+    uint8_t connected() override { return 1; }
+    size_t  write(const uint8_t* buffer, size_t size) override;
+
+    bool                 keep   = true;
+    std::vector<uint8_t> data;
+    size_t               bytes  = 0;
+    size_t               writes = 0;  // Calls to write(); a frame sent in one piece is one
+};
+
+// A web socket server with the given number of browsers connected, ready to broadcast to
+class HostSocketServer : public WebSocketsServer {
+public:
+    HostSocketServer(int clients);
+
+    HostSocketClient& client(int num) { return *static_cast<HostSocketClient*>(_clients[num].tcp); }
+};
+
+// Calls to malloc() from the firmware and library sources, and to operator new from
+// anywhere, since the program started
+extern size_t host_allocations;
+
+// The payloads of the binary frames in what a client received, oldest first. Parsing
+// stops at the first byte that does not start a complete, unmasked, final binary frame.
+std::vector<std::string> host_socket_frames(const HostSocketClient& client);
+
+// The web server task, on a thread of its own. Once resumed, each pass calls pass() and
+// then, as WebServer::handle() does, sleeps until notified or wait ticks go by. Frames
+// that reach client 0 of server are timed as they go out; read what the clients received
+// only after stop().
+class HostSenderTask {
+public:
+    HostSenderTask(HostSocketServer& server, std::function<void()> pass, TickType_t wait);
+    ~HostSenderTask() { stop(); }
+
+    TaskHandle_t handle() const { return _handle; }
+    void         resume();
+    void         stop();
+
+    // Waits up to ms milliseconds for count frames in all to have gone out
+    bool    wait_sent(size_t count, uint32_t ms);
+    size_t  sent();
+    int64_t sent_at(size_t frame);  // micros() when the frame had gone out
+
+private:
+    void run();
+
+    HostSocketServer&       _server;
+    std::function<void()>   _pass;
+    TickType_t              _wait;
+    TaskHandle_t            _handle = NULL;
+    std::atomic<bool>       _running { false };
+    std::atomic<bool>       _stopping { false };
+    std::mutex              _lock;
+    std::condition_variable _changed;
+    std::vector<int64_t>    _sent;  // Guarded by _lock
+    std::thread             _thread;
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+// Included ahead of each arduinoWebSockets source built for the tests in tests/, for
+// what the Arduino core and the ESP32 configuration of the library would define.
+// Firmware sources get bit() from NutsBolts.h instead.
+
+#include <Arduino.h>
+
+#define bit(b) (1UL << (b))
+#define GET_FREE_HEAP ESP.getFreeHeap()
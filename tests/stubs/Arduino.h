@@ -0,0 +1,307 @@
+#pragma once
+
+/*
+  Arduino.h - Host stand-in for the Arduino core, for the tests in tests/
+  Part of Grbl_ESP32
+
+  Only what the sources built on the host use is here. String keeps the
+  Arduino API on top of std::string.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <math.h>
+#include <stdexcept>
+#include <string>
+
+#include <binary.h>
+#include <esp32-hal.h>
+#include <freertos/FreeRTOS.h>
+#include <sdkconfig.h>
+
+using std::isfinite;
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define IRAM_ATTR
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x02
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+#define OPEN_DRAIN 0x10
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define DEC 10
+#define HEX 16
+#define SS 5
+#define PI 3.1415926535897932384626433832795
+
+#define F(string_literal) (string_literal)
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// From the ESP32 newlib, which glibc lacks
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size) {
+        size_t n = std::min(len, size - 1);
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+
+#define log_v(format, ...)
+#define log_d(format, ...)
+#define log_i(format, ...)
+#define log_w(format, ...)
+#define log_e(format, ...)
+
+class String {
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(int n, unsigned char base = 10) : _s(format(base == 16 ? "%x" : "%d", n)) {}
+    String(unsigned int n, unsigned char base = 10) : _s(format(base == 16 ? "%x" : "%u", n)) {}
+    String(long n, unsigned char base = 10) : _s(format(base == 16 ? "%lx" : "%ld", n)) {}
+    String(unsigned long n, unsigned char base = 10) : _s(format(base == 16 ? "%lx" : "%lu", n)) {}
+    String(long long n) : _s(std::to_string(n)) {}
+    String(unsigned long long n) : _s(std::to_string(n)) {}
+    String(float f, unsigned char decimals = 2) : _s(format("%.*f", decimals, f)) {}
+    String(double f, unsigned char decimals = 2) : _s(format("%.*f", decimals, f)) {}
+
+    const char*  c_str() const { return _s.c_str(); }
+    unsigned int length() const { return _s.length(); }
+    bool         reserve(unsigned int size) {
+        _s.reserve(size);
+        return true;
+    }
+
+    char  operator[](unsigned int i) const { return i < _s.length() ? _s[i] : 0; }
+    char& operator[](unsigned int i) { return _s[i]; }
+    char  charAt(unsigned int i) const { return (*this)[i]; }
+
+    String& operator=(const char* s) {
+        _s = s ? s : "";
+        return *this;
+    }
+    String& operator+=(const String& s) {
+        _s += s._s;
+        return *this;
+    }
+    String& operator+=(const char* s) {
+        _s += s ? s : "";
+        return *this;
+    }
+    String& operator+=(char c) {
+        _s += c;
+        return *this;
+    }
+    template <typename T>
+    String& operator+=(T n) {
+        return *this += String(n);
+    }
+    bool concat(const String& s) {
+        _s += s._s;
+        return true;
+    }
+
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b._s); }
+    friend String operator+(const String& a, char c) { return String(a._s + c); }
+    template <typename T>
+    friend String operator+(const String& a, T n) {
+        return a + String(n);
+    }
+
+    bool operator==(const String& s) const { return _s == s._s; }
+    bool operator==(const char* s) const { return _s == (s ? s : ""); }
+    bool operator!=(const String& s) const { return _s != s._s; }
+    bool operator!=(const char* s) const { return !(*this == s); }
+    bool operator<(const String& s) const { return _s < s._s; }
+    bool equals(const String& s) const { return _s == s._s; }
+    bool equalsIgnoreCase(const String& s) const { return strcasecmp(c_str(), s.c_str()) == 0; }
+
+    bool startsWith(const String& s) const { return _s.compare(0, s._s.length(), s._s) == 0; }
+    bool endsWith(const String& s) const {
+        return _s.length() >= s._s.length() && _s.compare(_s.length() - s._s.length(), s._s.length(), s._s) == 0;
+    }
+    int indexOf(char c, unsigned int from = 0) const { return pos(_s.find(c, from)); }
+    int indexOf(const String& s, unsigned int from = 0) const { return pos(_s.find(s._s, from)); }
+    int lastIndexOf(char c) const { return pos(_s.rfind(c)); }
+    int lastIndexOf(char c, unsigned int from) const { return pos(_s.rfind(c, from)); }
+    int lastIndexOf(const String& s) const { return pos(_s.rfind(s._s)); }
+
+    String substring(unsigned int from) const { return from < _s.length() ? String(_s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) {
+            std::swap(from, to);
+        }
+        return from < _s.length() ? String(_s.substr(from, to - from)) : String();
+    }
+
+    void remove(unsigned int index) { _s.erase(std::min<size_t>(index, _s.length())); }
+    void remove(unsigned int index, unsigned int count) {
+        if (index < _s.length()) {
+            _s.erase(index, count);
+        }
+    }
+    void replace(const String& from, const String& to) {
+        for (size_t p = 0; !from._s.empty() && (p = _s.find(from._s, p)) != std::string::npos; p += to._s.length()) {
+            _s.replace(p, from._s.length(), to._s);
+        }
+    }
+    void trim() {
+        size_t first = _s.find_first_not_of(" \t\r\n");
+        size_t last  = _s.find_last_not_of(" \t\r\n");
+        _s           = first == std::string::npos ? "" : _s.substr(first, last - first + 1);
+    }
+    void toLowerCase() {
+        for (auto& c : _s) {
+            c = tolower(c);
+        }
+    }
+    void toUpperCase() {
+        for (auto& c : _s) {
+            c = toupper(c);
+        }
+    }
+    void toCharArray(char* buf, unsigned int size, unsigned int index = 0) const {
+        if (size) {
+            size_t n = index < _s.length() ? std::min<size_t>(size - 1, _s.length() - index) : 0;
+            memcpy(buf, _s.c_str() + std::min<size_t>(index, _s.length()), n);
+            buf[n] = 0;
+        }
+    }
+    long  toInt() const { return atol(c_str()); }
+    float toFloat() const { return atof(c_str()); }
+
+private:
+    static std::string format(const char* fmt, ...) {
+        char    buf[64];
+        va_list arg;
+        va_start(arg, fmt);
+        vsnprintf(buf, sizeof(buf), fmt, arg);
+        va_end(arg);
+        return buf;
+    }
+    static int pos(size_t p) { return p == std::string::npos ? -1 : int(p); }
+
+    std::string _s;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) {
+            n += write(*buffer++);
+        }
+        return n;
+    }
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write(uint8_t(c)); }
+    size_t print(int n) { return print(String(n)); }
+    size_t println(const char* s = "") { return print(s) + write("\r\n"); }
+    size_t println(const String& s) { return print(s) + write("\r\n"); }
+    size_t printf(const char* format, ...) {
+        char    buf[256];
+        va_list arg;
+        va_start(arg, format);
+        vsnprintf(buf, sizeof(buf), format, arg);
+        va_end(arg);
+        return write(buf);
+    }
+    virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+    virtual int    available() = 0;
+    virtual int    read()      = 0;
+    virtual int    peek()      = 0;
+    void           setTimeout(unsigned long timeout) {}
+    virtual size_t readBytes(char* buffer, size_t length) {
+        size_t n = 0;
+        int    c;
+        while (n < length && (c = read()) >= 0) {
+            buffer[n++] = c;
+        }
+        return n;
+    }
+    String readStringUntil(char terminator) {
+        String s;
+        int    c;
+        while ((c = read()) >= 0 && c != terminator) {
+            s += char(c);
+        }
+        return s;
+    }
+};
+
+unsigned long millis();
+unsigned long micros();
+void          delay(uint32_t ms);
+void          delayMicroseconds(uint32_t us);
+void          yield();
+
+void    pinMode(uint8_t pin, uint8_t mode);
+void    digitalWrite(uint8_t pin, uint8_t val);
+int     digitalRead(uint8_t pin);
+void    attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void    detachInterrupt(uint8_t pin);
+
+inline long random(long howbig) {
+    return howbig ? ::random() % howbig : 0;
+}
+inline void randomSeed(unsigned long seed) {
+    srandom(seed);
+}
+
+// The chip. The host always has heap to spare.
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return 300000; }
+};
+
+extern EspClass ESP;
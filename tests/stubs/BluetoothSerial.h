@@ -0,0 +1,19 @@
+#pragma once
+
+// Host stand-in for the Arduino BluetoothSerial library, for the tests in tests/. Nothing ever connects.
+
+#include <Arduino.h>
+
+class BluetoothSerial : public Stream {
+public:
+    bool   begin(String name) { return true; }
+    void   end() {}
+    bool   hasClient() { return false; }
+    bool   isReady(bool checkMaster = false, int timeout = 0) { return false; }
+    int    available() override { return 0; }
+    int    read() override { return -1; }
+    int    peek() override { return -1; }
+    size_t write(uint8_t c) override { return 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { return size; }
+    void   register_callback(void (*callback)(int event, void* param)) {}
+};
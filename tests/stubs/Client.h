@@ -0,0 +1,14 @@
+#pragma once
+
+// Host stand-in for the Arduino Client class, for the tests in tests/. Tests derive stand-in servers from it.
+
+#include <Arduino.h>
+
+class IPAddress;
+
+class Client : public Stream {
+public:
+    virtual int     connect(const char* host, uint16_t port) = 0;
+    virtual uint8_t connected()                              = 0;
+    virtual void    stop()                                   = 0;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+/*
+  FS.h - Host stand-in for the Arduino file system API, for the tests in tests/
+  Part of Grbl_ESP32
+
+  Files live in memory, so tests can create a card's contents, run code
+  against it, and look at what was written.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+    enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+    struct Node {
+        bool                 directory = false;
+        std::vector<uint8_t> data;
+        time_t               last_write = 0;
+    };
+    struct Volume {
+        std::map<std::string, std::shared_ptr<Node>> nodes;
+        uint32_t                                     reads  = 0;         // read() calls that reached a file
+        uint32_t                                     writes = 0;         // write() calls that reached a file
+        time_t                                       clock  = 1;         // Modification time given to the next write
+        size_t                                       space  = SIZE_MAX;  // Bytes left before writes fail, as on a full card
+    };
+
+    class File : public Stream {
+    public:
+        File() {}
+        File(std::shared_ptr<Volume> volume, const std::string& path, std::shared_ptr<Node> node, bool writable) :
+            _volume(volume), _path(path), _node(node), _writable(writable) {}
+
+        size_t write(uint8_t c) override { return write(&c, 1); }
+        size_t write(const uint8_t* buf, size_t size) override;
+        int    available() override { return _node ? int(_node->data.size() - _pos) : 0; }
+        int    read() override;
+        int    peek() override;
+        size_t read(uint8_t* buf, size_t size);
+        bool   seek(uint32_t pos, SeekMode mode = SeekSet);
+        size_t position() const { return _pos; }
+        size_t size() const { return _node ? _node->data.size() : 0; }
+        void   close();
+        time_t getLastWrite() { return _node ? _node->last_write : 0; }
+        const char* name() const { return _path.c_str(); }
+        bool        isDirectory() { return _node && _node->directory; }
+        File        openNextFile(const char* mode = FILE_READ);
+        void        rewindDirectory() { _next = 0; }
+        operator bool() const { return _node != nullptr; }
+
+    private:
+        std::shared_ptr<Volume> _volume;
+        std::string             _path;
+        std::shared_ptr<Node>   _node;
+        bool                    _writable = false;
+        size_t                  _pos      = 0;
+        size_t                  _next     = 0;  // Directory entries already returned
+    };
+
+    class FS {
+    public:
+        FS() : _volume(std::make_shared<Volume>()) { _volume->nodes["/"] = std::make_shared<Node>(Node { true }); }
+
+        File open(const char* path, const char* mode = FILE_READ);
+        File open(const String& path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+        bool exists(const char* path) { return _volume->nodes.count(path) != 0; }
+        bool exists(const String& path) { return exists(path.c_str()); }
+        bool remove(const char* path);
+        bool remove(const String& path) { return remove(path.c_str()); }
+        bool rename(const char* from, const char* to);
+        bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+        bool mkdir(const char* path);
+        bool mkdir(const String& path) { return mkdir(path.c_str()); }
+        bool rmdir(const char* path);
+        bool rmdir(const String& path) { return rmdir(path.c_str()); }
+
+        // For tests: the whole contents of a file, and the volume with its counters and clock
+        void        put(const char* path, const std::string& data);
+        std::string get(const char* path);
+        Volume&     volume() { return *_volume; }
+
+    protected:
+        std::shared_ptr<Volume> _volume;
+    };
+}
+
+using fs::File;
+using fs::FS;
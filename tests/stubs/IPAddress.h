@@ -0,0 +1,31 @@
+#pragma once
+
+// Host stand-in for the Arduino IPAddress class, for the tests in tests/
+
+#include <Arduino.h>
+
+class IPAddress {
+public:
+    IPAddress(uint32_t address = 0) : _address(address) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _address(a | b << 8 | c << 16 | uint32_t(d) << 24) {}
+    bool fromString(const char* address) {
+        unsigned a, b, c, d;
+        char     end;
+        if (sscanf(address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &end) != 4 || a > 255 || b > 255 || c > 255 || d > 255) {
+            return false;
+        }
+        *this = IPAddress(a, b, c, d);
+        return true;
+    }
+    bool fromString(const String& address) { return fromString(address.c_str()); }
+    operator uint32_t() const { return _address; }
+    bool   operator==(const IPAddress& ip) const { return _address == ip._address; }
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _address & 0xff, _address >> 8 & 0xff, _address >> 16 & 0xff, _address >> 24);
+        return buf;
+    }
+
+private:
+    uint32_t _address;
+};
@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in for the Arduino Preferences library, for the tests in tests/
+
+#include <Arduino.h>
@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in for the Arduino Print class, for the tests in tests/. It is declared in Arduino.h.
+
+#include <Arduino.h>
@@ -0,0 +1,24 @@
+#pragma once
+
+// Host stand-in for the Arduino SD library, for the tests in tests/. The card is the in-memory file system of FS.h.
+
+#include <FS.h>
+#include <SPI.h>
+
+typedef enum { CARD_NONE, CARD_MMC, CARD_SD, CARD_SDHC, CARD_UNKNOWN } sdcard_type_t;
+
+class SDFS : public fs::FS {
+public:
+    bool begin(uint8_t ssPin = SS, SPIClass& spi = SPI, uint32_t frequency = 4000000, const char* mountpoint = "/sd", uint8_t max_files = 5) {
+        return _present;
+    }
+    void          end() {}
+    sdcard_type_t cardType() { return _present ? CARD_SDHC : CARD_NONE; }
+    uint64_t      cardSize() { return _present ? 4ULL << 30 : 0; }
+    uint64_t      totalBytes() { return cardSize(); }
+    uint64_t      usedBytes() { return 0; }
+
+    bool _present = true;  // For tests: whether a card is inserted
+};
+
+extern SDFS SD;
@@ -0,0 +1,9 @@
+#pragma once
+
+// Host stand-in for the Arduino SPI library, for the tests in tests/
+
+#include <Arduino.h>
+
+class SPIClass {};
+
+extern SPIClass SPI;
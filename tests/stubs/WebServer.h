@@ -0,0 +1,23 @@
+#pragma once
+
+// Host stand-in for the ESP32 WebServer library, for the tests in tests/
+
+#include <Arduino.h>
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+// Keeps everything a handler sends, for tests to look at
+class WebServer {
+public:
+    void setContentLength(size_t length) {}
+    void sendHeader(const String& name, const String& value, bool first = false) { headers += name + ": " + value + "\r\n"; }
+    void send(int code, const char* content_type = NULL, const String& content = String()) {
+        this->code = code;
+        body += content;
+    }
+    void sendContent(const String& content) { body += content; }
+
+    int    code = 0;
+    String headers;
+    String body;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+// Host stand-in for the Arduino WiFi library, for the tests in tests/. Nothing ever connects.
+
+#include <Arduino.h>
+#include <Client.h>
+#include <IPAddress.h>
+
+typedef int WiFiEvent_t;
+
+class WiFiClient : public Client {
+public:
+    virtual ~WiFiClient() {}
+    int          connect(const char* host, uint16_t port) override { return 0; }
+    uint8_t      connected() override { return 0; }
+    void         stop() override {}
+    IPAddress    remoteIP() { return IPAddress(); }
+    int          available() override { return 0; }
+    int          read() override { return -1; }
+    int          read(uint8_t* buf, size_t size) { return 0; }
+    int          peek() override { return -1; }
+    size_t       write(uint8_t c) override { return 1; }
+    size_t       write(const uint8_t* buffer, size_t size) override { return size; }
+    using Print::write;
+    void         setNoDelay(bool nodelay) {}
+    operator bool() { return connected(); }
+};
+
+class WiFiServer {
+public:
+    WiFiServer(uint16_t port) {}
+    void       begin() {}
+    void       end() {}
+    void       setNoDelay(bool nodelay) {}
+    bool       hasClient() { return false; }
+    WiFiClient available() { return WiFiClient(); }
+};
+
+typedef enum { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA } wifi_mode_t;
+
+// The radio, in whatever mode a test sets
+class WiFiClass {
+public:
+    wifi_mode_t getMode() { return _mode; }
+    bool        mode(wifi_mode_t mode) {
+        _mode = mode;
+        return true;
+    }
+
+private:
+    wifi_mode_t _mode = WIFI_OFF;
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,7 @@
+#pragma once
+
+// Host stand-in for the Arduino WiFiClientSecure library, for the tests in tests/
+
+#include <WiFi.h>
+
+class WiFiClientSecure : public WiFiClient {};
@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in for the Arduino Wire library, for the tests in tests/
+
+#include <Arduino.h>
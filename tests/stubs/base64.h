@@ -0,0 +1,23 @@
+#pragma once
+
+// Host stand-in for the Arduino base64 library, for the tests in tests/
+
+#include <Arduino.h>
+
+class base64 {
+public:
+    static String encode(const String& text) {
+        static const char* digits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        const uint8_t*     in     = (const uint8_t*)text.c_str();
+        size_t             len    = text.length();
+        String             out;
+        for (size_t i = 0; i < len; i += 3) {
+            uint32_t n = in[i] << 16 | (i + 1 < len ? in[i + 1] << 8 : 0) | (i + 2 < len ? in[i + 2] : 0);
+            out += digits[n >> 18 & 63];
+            out += digits[n >> 12 & 63];
+            out += i + 1 < len ? digits[n >> 6 & 63] : '=';
+            out += i + 2 < len ? digits[n & 63] : '=';
+        }
+        return out;
+    }
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF timer driver, for the tests in tests/
+
+#include <Arduino.h>
+
+typedef enum { TIMER_GROUP_0, TIMER_GROUP_1 } timer_group_t;
+typedef enum { TIMER_0, TIMER_1 } timer_idx_t;
@@ -0,0 +1,16 @@
+#pragma once
+
+// Host stand-in for the ESP32 Arduino HAL, for the tests in tests/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+int64_t esp_timer_get_time();
+
+inline bool psramFound() {
+    return false;
+}
+inline void* ps_malloc(size_t size) {
+    return malloc(size);
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF task watchdog, for the tests in tests/
+
+#include <Arduino.h>
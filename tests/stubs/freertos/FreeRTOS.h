@@ -0,0 +1,99 @@
+#pragma once
+
+/*
+  FreeRTOS.h - Host stand-in for the FreeRTOS API, for the tests in tests/
+  Part of Grbl_ESP32
+
+  Tasks are threads, queues and mutexes are guarded by std::mutex, and a tick
+  is a millisecond, so code that hands work between tasks runs unchanged.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+#define portBASE_TYPE int
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xFFFFFFFF
+#define portTICK_PERIOD_MS 1
+#define portTICK_RATE_MS 1
+#define configTICK_RATE_HZ 1000
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+struct host_task;
+struct host_queue;
+struct host_mux;
+
+typedef host_task*  TaskHandle_t;
+typedef host_queue* QueueHandle_t;
+typedef host_queue* xQueueHandle;
+typedef host_queue* SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+// A portMUX_TYPE is a recursive lock here; critical sections only exclude each other
+struct portMUX_TYPE {
+    host_mux* mux;
+};
+#define portMUX_INITIALIZER_UNLOCKED \
+    { nullptr }
+
+void vPortCPUInitializeMutex(portMUX_TYPE* mux);
+void vTaskEnterCritical(portMUX_TYPE* mux);
+void vTaskExitCritical(portMUX_TYPE* mux);
+#define portENTER_CRITICAL(mux) vTaskEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) vTaskExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vTaskEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) vTaskExitCritical(mux)
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn,
+                                   const char*    name,
+                                   uint32_t       stack,
+                                   void*          param,
+                                   UBaseType_t    priority,
+                                   TaskHandle_t*  handle,
+                                   BaseType_t     core);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* param, UBaseType_t priority, TaskHandle_t* handle);
+void       vTaskDelay(TickType_t ticks);
+void       vTaskDelayUntil(TickType_t* previous_wake, TickType_t ticks);
+void       vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TickType_t   xTaskGetTickCount();
+BaseType_t   xTaskNotifyGive(TaskHandle_t task);
+uint32_t     ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+UBaseType_t  uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t   xPortInIsrContext();
+size_t       xPortGetFreeHeapSize();
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+BaseType_t    xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks);
+BaseType_t    xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks);
+BaseType_t    xQueueReset(QueueHandle_t queue);
+UBaseType_t   uxQueueMessagesWaiting(QueueHandle_t queue);
+void          vQueueDelete(QueueHandle_t queue);
+BaseType_t    xQueueIsQueueFullFromISR(QueueHandle_t queue);
+#define xQueueSendFromISR(queue, item, woken) xQueueSend(queue, item, 0)
+#define xQueueReceiveFromISR(queue, item, woken) xQueueReceive(queue, item, 0)
+#define xQueueSendToBack xQueueSend
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t        xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t        xSemaphoreGive(SemaphoreHandle_t sem);
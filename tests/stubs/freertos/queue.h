@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in for FreeRTOS queues, for the tests in tests/. They are declared in FreeRTOS.h.
+
+#include "FreeRTOS.h"
@@ -0,0 +1,38 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF NVS API, for the tests in tests/.
+// Values are kept in memory for the life of the process.
+
+#include <cstddef>
+#include <cstdint>
+
+typedef int      esp_err_t;
+typedef uint32_t nvs_handle;
+typedef struct {
+    size_t used_entries;
+    size_t free_entries;
+    size_t total_entries;
+    size_t namespace_count;
+} nvs_stats_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NVS_BASE 0x1100
+#define ESP_ERR_NVS_NOT_FOUND (ESP_ERR_NVS_BASE + 0x02)
+#define ESP_ERR_NVS_INVALID_HANDLE (ESP_ERR_NVS_BASE + 0x07)
+#define ESP_ERR_NVS_INVALID_NAME (ESP_ERR_NVS_BASE + 0x08)
+#define ESP_ERR_NVS_INVALID_LENGTH (ESP_ERR_NVS_BASE + 0x0c)
+
+esp_err_t nvs_open(const char* name, nvs_open_mode open_mode, nvs_handle* out_handle);
+esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats);
+esp_err_t nvs_erase_all(nvs_handle handle);
+esp_err_t nvs_erase_key(nvs_handle handle, const char* key);
+esp_err_t nvs_get_i8(nvs_handle handle, const char* key, int8_t* out_value);
+esp_err_t nvs_set_i8(nvs_handle handle, const char* key, int8_t value);
+esp_err_t nvs_get_i32(nvs_handle handle, const char* key, int32_t* out_value);
+esp_err_t nvs_set_i32(nvs_handle handle, const char* key, int32_t value);
+esp_err_t nvs_get_str(nvs_handle handle, const char* key, char* out_value, size_t* length);
+esp_err_t nvs_set_str(nvs_handle handle, const char* key, const char* value);
+esp_err_t nvs_get_blob(nvs_handle handle, const char* key, void* out_value, size_t* length);
+esp_err_t nvs_set_blob(nvs_handle handle, const char* key, const void* value, size_t length);
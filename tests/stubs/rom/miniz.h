@@ -0,0 +1,75 @@
+#pragma once
+
+// Host stand-in for the miniz inflater in the ESP32 ROM, for the tests in tests/.
+// It is built on zlib's raw inflate, which keeps its own history, so the output
+// window can wrap as it does with tinfl. zlib allocates from an arena inside the
+// decompressor, so freeing the decompressor frees everything, as it does on the ESP32.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <zlib.h>
+
+const size_t TINFL_LZ_DICT_SIZE = 32768;
+
+enum { TINFL_FLAG_HAS_MORE_INPUT = 2 };
+
+typedef enum {
+    TINFL_STATUS_FAILED           = -1,
+    TINFL_STATUS_DONE             = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT  = 2,
+} tinfl_status;
+
+typedef struct {
+    z_stream stream;
+    size_t   arena_used;
+    uint8_t  arena[48 * 1024];  // Inflate state and its 32K window
+} tinfl_decompressor;
+
+inline voidpf tinfl_host_alloc(voidpf opaque, uInt items, uInt size) {
+    tinfl_decompressor* r    = (tinfl_decompressor*)opaque;
+    size_t              need = (size_t(items) * size + 15) & ~size_t(15);
+    if (r->arena_used + need > sizeof(r->arena)) {
+        return Z_NULL;
+    }
+    voidpf p = r->arena + r->arena_used;
+    r->arena_used += need;
+    return p;
+}
+inline void tinfl_host_free(voidpf opaque, voidpf address) {}
+
+inline void tinfl_init(tinfl_decompressor* r) {
+    memset(&r->stream, 0, sizeof(r->stream));
+    r->arena_used    = 0;
+    r->stream.zalloc = tinfl_host_alloc;
+    r->stream.zfree  = tinfl_host_free;
+    r->stream.opaque = r;
+    inflateInit2(&r->stream, -15);
+}
+
+inline tinfl_status tinfl_decompress(tinfl_decompressor* r,
+                                     const uint8_t*      in,
+                                     size_t*             in_len,
+                                     uint8_t*            out_start,
+                                     uint8_t*            out_next,
+                                     size_t*             out_len,
+                                     uint32_t            flags) {
+    r->stream.next_in   = (Bytef*)in;
+    r->stream.avail_in  = *in_len;
+    r->stream.next_out  = out_next;
+    r->stream.avail_out = *out_len;
+    int status          = inflate(&r->stream, Z_NO_FLUSH);
+    *in_len -= r->stream.avail_in;
+    *out_len -= r->stream.avail_out;
+    if (status == Z_STREAM_END) {
+        return TINFL_STATUS_DONE;
+    }
+    if (status != Z_OK && status != Z_BUF_ERROR) {
+        return TINFL_STATUS_FAILED;
+    }
+    if (r->stream.avail_out == 0) {
+        return TINFL_STATUS_HAS_MORE_OUTPUT;
+    }
+    return (flags & TINFL_FLAG_HAS_MORE_INPUT) ? TINFL_STATUS_NEEDS_MORE_INPUT : TINFL_STATUS_FAILED;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF build configuration, for the tests in tests/
+
+#define CONFIG_BT_ENABLED 1
+#define CONFIG_BLUEDROID_ENABLED 1
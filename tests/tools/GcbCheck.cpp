@@ -0,0 +1,59 @@
+/*
+  GcbCheck.cpp - Checks that a compiled sidecar was made from a g-code file
+  Part of Grbl_ESP32
+
+  Usage: gcb_check <file.nc> [<file.nc.gcb>]
+  The firmware uses a sidecar while its source keeps the size, modification time
+  and hash in the sidecar header. This compares the header with the source, size
+  and hash, for a card read on a computer. Copying a file usually changes its
+  modification time, so that is not compared. Exits with 0 if the sidecar matches.
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Host.h"
+
+#include <fstream>
+#include <iterator>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <file.nc> [<file.nc.gcb>]\n", argv[0]);
+        return 2;
+    }
+    std::string   source_path   = argv[1];
+    std::string   compiled_path = argc > 2 ? argv[2] : source_path + SD_COMPILED_SUFFIX;
+    std::ifstream source(source_path, std::ios::binary);
+    std::ifstream compiled(compiled_path, std::ios::binary);
+    if (!source || !compiled) {
+        fprintf(stderr, "Cannot open %s\n", source ? compiled_path.c_str() : source_path.c_str());
+        return 2;
+    }
+    sd_compiled_header_t header;
+    if (!compiled.read((char*)&header, sizeof(header)) || header.magic != SD_COMPILED_MAGIC) {
+        printf("%s: not a sidecar of this version\n", compiled_path.c_str());
+        return 1;
+    }
+    std::string data((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+    uint32_t    hash = 2166136261u;  // FNV-1a, as compileFile() computes it
+    for (unsigned char c : data) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    if (header.source_size != data.size() || header.source_hash != hash) {
+        printf("%s: stale, made from another version of %s\n", compiled_path.c_str(), source_path.c_str());
+        return 1;
+    }
+    printf("%s: matches %s\n", compiled_path.c_str(), source_path.c_str());
+    return 0;
+}